@@ -0,0 +1,81 @@
+#include "test_base.h"
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+// Проверка режима ALT: маршруты A* с оценкой по ориентирам должны совпасть по времени с поиском Дейкстры,
+// а оценка graph::Landmarks - не превышать кратчайшего пути из таблицы всех пар и быть бесконечной,
+// только если пути нет
+
+using namespace tc_project;
+using namespace tc_project::test;
+using namespace std::literals;
+
+namespace {
+
+constexpr size_t STOP_COUNT = 40;
+constexpr size_t BUS_COUNT = 14;
+
+const std::vector<std::string> GRAPH_MODELS = { "complete"s, "linear"s };
+
+// один ориентир, по умолчанию и больше, чем вершин с рёбрами
+const std::vector<int> LANDMARK_COUNTS = { 1, 8, 1000 };
+
+}//namespace
+
+int main() {
+	const TestBase base = MakeTestBase(STOP_COUNT, BUS_COUNT, 17);
+
+	size_t failures = 0;
+	for (const std::string& graph_model : GRAPH_MODELS) {
+		transport_catalogue::TransportCatalogue expected_catalogue;
+		transport_router::TransportRouter expected_router;
+		Fill(expected_catalogue, expected_router, base.MakeDocument(MakeRoutingSettings("all_pairs"s, graph_model)));
+		const auto& expected_table = *expected_router.GetRouter();
+		const size_t vertex_count = expected_router.GetGraph().GetVertexCount();
+
+		for (const int landmark_count : LANDMARK_COUNTS) {
+			const std::string context = graph_model + ", "s + std::to_string(landmark_count) + " landmark(s): "s;
+			json::Dict routing_settings = MakeRoutingSettings("alt"s, graph_model);
+			routing_settings["landmark_count"s] = landmark_count;
+
+			transport_catalogue::TransportCatalogue catalogue;
+			transport_router::TransportRouter router;
+			Fill(catalogue, router, base.MakeDocument(routing_settings));
+			const auto& graph = router.GetGraph();
+			if (!Check(router.GetLandmarks() && graph.GetVertexCount() == vertex_count, context + "no landmarks or another graph"s)) {
+				++failures;
+				continue;
+			}
+
+			// тот же поиск Дейкстры без оценки
+			const graph::DijkstraRouter<transport_router::RouteWeight> dijkstra(graph);
+			size_t route_mismatches = 0;
+			for (graph::VertexId from = 0; from < STOP_COUNT; ++from) {
+				for (graph::VertexId to = 0; to < STOP_COUNT; ++to) {
+					const std::string from_name(router.GetStopNameFromID(from));
+					const std::string to_name(router.GetStopNameFromID(to));
+					route_mismatches += !IsSameRoute(graph, from, to, router.BuildRouter(from_name, to_name), dijkstra.BuildRoute(from, to));
+				}
+			}
+			failures += !Check(route_mismatches == 0, context + std::to_string(route_mismatches) + " route(s) differ from Dijkstra"s);
+
+			// оценка по всем вершинам графа, в модели LINEAR и по вершинам поездки
+			size_t bad_bounds = 0;
+			for (graph::VertexId from = 0; from < vertex_count; ++from) {
+				for (graph::VertexId to = 0; to < vertex_count; ++to) {
+					const double bound = router.GetLandmarks()->GetLowerBound(from, to).total_time;
+					const auto weight = expected_table.GetRouteWeight(from, to);
+					if (!weight) {
+						continue;
+					}
+					bad_bounds += std::isinf(bound) || bound > weight->total_time * (1 + 1e-9) + 1e-9 || (from == to && bound != 0.0);
+				}
+			}
+			failures += !Check(bad_bounds == 0, context + std::to_string(bad_bounds) + " lower bound(s) above the shortest path"s);
+		}
+	}
+
+	return Finish(failures);
+}
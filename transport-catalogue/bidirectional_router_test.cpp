@@ -0,0 +1,93 @@
+#include "test_base.h"
+
+#include <string>
+#include <vector>
+
+// Проверка поиска Дейкстры навстречу: маршрут между любыми вершинами графа должен совпасть по времени
+// с обычным поиском Дейкстры, а входящие рёбра вершины - с перебором всех рёбер, в том числе
+// после RemoveBus и AddBus
+
+using namespace tc_project;
+using namespace tc_project::test;
+using namespace std::literals;
+
+namespace {
+
+constexpr size_t STOP_COUNT = 40;
+constexpr size_t BUS_COUNT = 14;
+
+const std::vector<std::string> GRAPH_MODELS = { "complete"s, "linear"s };
+
+using Graph = graph::DirectedWeightedGraph<transport_router::RouteWeight>;
+
+// число вершин, у которых входящие или исходящие рёбра отличаются от перебора в порядке номеров
+size_t CountAdjacencyMismatches(const Graph& graph) {
+	std::vector<std::vector<graph::EdgeId>> incoming(graph.GetVertexCount());
+	std::vector<std::vector<graph::EdgeId>> incident(graph.GetVertexCount());
+	for (graph::EdgeId edge_id = 0; edge_id < graph.GetEdgeCount(); ++edge_id) {
+		incoming[graph.GetEdge(edge_id).to].push_back(edge_id);
+		incident[graph.GetEdge(edge_id).from].push_back(edge_id);
+	}
+
+	size_t mismatches = 0;
+	for (graph::VertexId vertex = 0; vertex < graph.GetVertexCount(); ++vertex) {
+		const auto incoming_range = graph.GetIncomingEdges(vertex);
+		const auto incident_range = graph.GetIncidentEdges(vertex);
+		mismatches += std::vector<graph::EdgeId>(incoming_range.begin(), incoming_range.end()) != incoming[vertex]
+			|| std::vector<graph::EdgeId>(incident_range.begin(), incident_range.end()) != incident[vertex];
+	}
+	return mismatches;
+}
+
+// маршруты между вершинами [0, vertex_count) навстречу и обычным поиском
+size_t CountRouteMismatches(const Graph& graph, size_t vertex_count) {
+	const graph::DijkstraRouter<transport_router::RouteWeight> dijkstra(graph);
+	size_t mismatches = 0;
+	for (graph::VertexId from = 0; from < vertex_count; ++from) {
+		for (graph::VertexId to = 0; to < vertex_count; ++to) {
+			mismatches += !IsSameRoute(graph, from, to, dijkstra.BuildRouteBidirectional(from, to), dijkstra.BuildRoute(from, to));
+		}
+	}
+	return mismatches;
+}
+
+}//namespace
+
+int main() {
+	const TestBase base = MakeTestBase(STOP_COUNT, BUS_COUNT, 18);
+
+	size_t failures = 0;
+	for (const std::string& graph_model : GRAPH_MODELS) {
+		transport_catalogue::TransportCatalogue catalogue;
+		transport_router::TransportRouter router;
+		Fill(catalogue, router, base.MakeDocument(MakeRoutingSettings("bidirectional_dijkstra"s, graph_model)));
+		const Graph& graph = router.GetGraph();
+
+		failures += !Check(CountAdjacencyMismatches(graph) == 0, graph_model + ": "s + "incident or incoming edges differ from the edge scan"s);
+		failures += !Check(CountRouteMismatches(graph, graph.GetVertexCount()) == 0, graph_model + ": "s + "bidirectional routes differ from Dijkstra"s);
+
+		// режим маршрутизатора ищет навстречу между остановками
+		const graph::DijkstraRouter<transport_router::RouteWeight> dijkstra(graph);
+		size_t stop_mismatches = 0;
+		for (graph::VertexId from = 0; from < STOP_COUNT; ++from) {
+			for (graph::VertexId to = 0; to < STOP_COUNT; ++to) {
+				const std::string from_name(router.GetStopNameFromID(from));
+				const std::string to_name(router.GetStopNameFromID(to));
+				stop_mismatches += !IsSameRoute(graph, from, to, router.BuildRouter(from_name, to_name), dijkstra.BuildRoute(from, to));
+			}
+		}
+		failures += !Check(stop_mismatches == 0, graph_model + ": "s + std::to_string(stop_mismatches) + " stop route(s) differ from Dijkstra"s);
+
+		// RemoveBus и AddBus меняют рёбра, входящие рёбра строятся заново; маршруты - между остановками
+		for (size_t bus = 0; bus < BUS_COUNT; bus += 3) {
+			router.RemoveBus(BusName(bus));
+			failures += !Check(CountAdjacencyMismatches(graph) == 0 && CountRouteMismatches(graph, STOP_COUNT) == 0,
+				graph_model + ": "s + "edges or routes are wrong after RemoveBus of "s + BusName(bus));
+			router.AddBus(catalogue, *catalogue.FindBus(BusName(bus)));
+			failures += !Check(CountAdjacencyMismatches(graph) == 0 && CountRouteMismatches(graph, STOP_COUNT) == 0,
+				graph_model + ": "s + "edges or routes are wrong after AddBus of "s + BusName(bus));
+		}
+	}
+
+	return Finish(failures);
+}
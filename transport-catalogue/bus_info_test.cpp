@@ -0,0 +1,152 @@
+#include "map_renderer.h"
+#include "serialization.h"
+#include "test_base.h"
+
+#include <transport_catalogue.pb.h>
+
+#include <algorithm>
+#include <map>
+#include <optional>
+#include <set>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Проверка BusInfo, посчитанных один раз после заполнения каталога и сохранённых в базе: они должны совпасть
+// с подсчётом по входным данным в лоб, в том числе после DeSerialize. Автобус без расстояния между
+// соседними остановками остаётся непосчитанным и в каталоге, и в базе
+
+using namespace tc_project;
+using namespace tc_project::test;
+using namespace std::literals;
+
+namespace {
+
+constexpr size_t STOP_COUNT = 40;
+constexpr size_t BUS_COUNT = 14;
+
+const std::string BROKEN_BUS = "Broken bus"s;
+
+using DistanceModel = std::map<std::pair<size_t, size_t>, unsigned int>;
+
+// расстояние в обратную сторону берётся из прямого, если его нет во входных данных
+DistanceModel MakeDistanceModel(const TestBase& base) {
+	DistanceModel model(base.road_distances.begin(), base.road_distances.end());
+	for (const auto& [stops_pair, distance] : base.road_distances) {
+		model.emplace(std::pair(stops_pair.second, stops_pair.first), distance);
+	}
+	return model;
+}
+
+// маршрут как в каталоге: некольцевой идёт до конца и обратно
+std::vector<size_t> MakeRoute(const BusDescription& bus) {
+	std::vector<size_t> route = bus.stops;
+	if (!bus.is_roundtrip) {
+		route.insert(route.end(), bus.stops.rbegin() + 1, bus.stops.rend());
+	}
+	return route;
+}
+
+// nullopt, если между соседними остановками расстояние не задано
+std::optional<domain::BusInfo> ComputeBusInfoByScan(const TestBase& base, const DistanceModel& model, const BusDescription& bus) {
+	const std::vector<size_t> route = MakeRoute(bus);
+	double route_length = 0.0;
+	double geo_length = 0.0;
+	for (size_t i = 0; i + 1 < route.size(); ++i) {
+		const auto it = model.find({ route[i], route[i + 1] });
+		if (it == model.end()) {
+			return std::nullopt;
+		}
+		route_length += it->second;
+		geo_length += geo::ComputeDistance(base.stops[route[i]], base.stops[route[i + 1]]);
+	}
+	const std::set<size_t> unique_stops(route.begin(), route.end());
+	return domain::BusInfo(route.size(), unique_stops.size(), route_length, route_length / geo_length);
+}
+
+bool IsSameBusInfo(const std::optional<domain::BusInfo>& info, const std::optional<domain::BusInfo>& expected) {
+	if (info.has_value() != expected.has_value()) {
+		return false;
+	}
+	return !info || (info->stops == expected->stops && info->unique_stop == expected->unique_stop
+		&& info->route_length == expected->route_length && IsSameTime(info->route_curvature, expected->route_curvature));
+}
+
+// число автобусов, у которых посчитанный BusInfo не совпадает с подсчётом в лоб
+size_t CountMismatches(const transport_catalogue::TransportCatalogue& catalogue, const TestBase& base, const DistanceModel& model) {
+	size_t mismatches = 0;
+	for (const BusDescription& bus : base.buses) {
+		const domain::Bus* bus_ptr = catalogue.FindBus(bus.name);
+		mismatches += !bus_ptr || !IsSameBusInfo(catalogue.GetComputedBusInfo(bus_ptr->id), ComputeBusInfoByScan(base, model, bus));
+	}
+	return mismatches;
+}
+
+}//namespace
+
+int main() {
+	TestBase base = MakeTestBase(STOP_COUNT, BUS_COUNT, 22);
+
+	// автобус между остановками, расстояние между которыми не задано ни в одну сторону
+	DistanceModel model = MakeDistanceModel(base);
+	std::optional<std::pair<size_t, size_t>> broken_stops;
+	for (size_t from = 0; from < STOP_COUNT && !broken_stops; ++from) {
+		for (size_t to = from + 1; to < STOP_COUNT && !broken_stops; ++to) {
+			if (!model.count({ from, to })) {
+				broken_stops = std::pair(from, to);
+			}
+		}
+	}
+	base.buses.push_back(BusDescription{ BROKEN_BUS, { broken_stops->first, broken_stops->second }, false });
+
+	size_t failures = 0;
+	transport_catalogue::TransportCatalogue catalogue;
+	transport_router::TransportRouter router;
+	Fill(catalogue, router, base.MakeDocument(MakeRoutingSettings("dijkstra"s)));
+
+	const size_t mismatches = CountMismatches(catalogue, base, model);
+	failures += !Check(mismatches == 0, std::to_string(mismatches) + " bus(es) with BusInfo different from the scan"s);
+	failures += !Check(!catalogue.GetComputedBusInfo(catalogue.FindBus(BROKEN_BUS)->id), "the bus without a road distance has BusInfo"s);
+
+	// в базе BusInfo есть у всех автобусов, кроме автобуса без расстояния
+	std::stringstream stream;
+	render::MapRenderer renderer;
+	Serialize(catalogue, renderer, router, stream);
+	proto::TransportCatalogue catalogue_proto;
+	if (!Check(catalogue_proto.ParseFromString(stream.str()), "the base can't be parsed"s)) {
+		return Finish(failures + 1);
+	}
+	size_t bad_flags = 0;
+	for (const proto::Bus& bus : catalogue_proto.list_of_buses()) {
+		bad_flags += bus.has_info() == (bus.name() == BROKEN_BUS);
+	}
+	failures += !Check(bad_flags == 0 && catalogue_proto.list_of_buses_size() == static_cast<int>(base.buses.size()),
+		std::to_string(bad_flags) + " bus(es) stored with a wrong BusInfo presence"s);
+
+	{
+		// после DeSerialize BusInfo читаются из базы и совпадают с подсчётом в лоб
+		stream.seekg(0);
+		transport_catalogue::TransportCatalogue loaded_catalogue;
+		render::MapRenderer loaded_renderer;
+		transport_router::TransportRouter loaded_router;
+		DeSerialize(loaded_catalogue, loaded_renderer, loaded_router, stream);
+		const size_t loaded_mismatches = CountMismatches(loaded_catalogue, base, model);
+		failures += !Check(loaded_mismatches == 0, std::to_string(loaded_mismatches) + " bus(es) with BusInfo different from the scan after DeSerialize"s);
+		const domain::Bus* broken_bus = loaded_catalogue.FindBus(BROKEN_BUS);
+		failures += !Check(broken_bus && !loaded_catalogue.GetComputedBusInfo(broken_bus->id), "the bus without a road distance has BusInfo after DeSerialize"s);
+	}
+
+	// новое расстояние сбрасывает посчитанное: запрос Bus считает сам, в том числе для автобуса без расстояния
+	catalogue.AddDistanceFromTo(StopName(broken_stops->first), StopName(broken_stops->second), 1000);
+	model[*broken_stops] = 1000;
+	model.emplace(std::pair(broken_stops->second, broken_stops->first), 1000);
+	size_t recomputed_mismatches = 0;
+	for (const BusDescription& bus : base.buses) {
+		recomputed_mismatches += !IsSameBusInfo(catalogue.GetBusInfo(bus.name), ComputeBusInfoByScan(base, model, bus));
+	}
+	failures += !Check(!catalogue.GetComputedBusInfo(0) && recomputed_mismatches == 0,
+		std::to_string(recomputed_mismatches) + " bus(es) with BusInfo different from the scan after AddDistanceFromTo"s);
+
+	return Finish(failures);
+}
@@ -0,0 +1,492 @@
+#pragma once
+
+#include "router.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+    // Иерархия сжатия (Contraction Hierarchies): вершины по очереди "сжимаются",
+    // а кратчайшие пути через них заменяются шорткатами. Запрос - двунаправленный
+    // поиск только по рёбрам, ведущим к вершинам с большим рангом.
+    // Идентификаторы рёбер [0, E) - рёбра исходного графа, E + i - i-й шорткат.
+    template <typename Weight>
+    class ContractionHierarchy {
+    private:
+        using Graph = DirectedWeightedGraph<Weight>;
+
+    public:
+        using RouteInfo = typename Router<Weight>::RouteInfo;
+
+        struct Shortcut {
+            VertexId from;
+            VertexId to;
+            Weight weight;
+            EdgeId first_edge;
+            EdgeId second_edge;
+        };
+
+        explicit ContractionHierarchy(const Graph& graph);
+        // иерархия, сохранённая в базе; std::invalid_argument, если ранги или шорткаты не подходят к графу.
+        // Шорткат i может ссылаться только на рёбра с меньшими номерами, чем E + i, и соединять их концы
+        ContractionHierarchy(const Graph& graph, std::vector<size_t> ranks, std::vector<Shortcut> shortcuts);
+
+        std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const;
+
+        const std::vector<size_t>& GetRanks() const;
+        const std::vector<Shortcut>& GetShortcuts() const;
+
+    private:
+        struct Arc {
+            VertexId vertex;
+            Weight weight;
+            EdgeId edge;
+        };
+
+        struct QueueItem {
+            Weight weight;
+            VertexId vertex;
+
+            bool operator>(const QueueItem& other) const {
+                return weight > other.weight;
+            }
+        };
+
+        using ArcLists = std::vector<std::vector<Arc>>;
+        using Queue = std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>>;
+
+        // ограничение на число вершин, просматриваемых при поиске свидетеля
+        static constexpr size_t WITNESS_SETTLE_LIMIT = 100;
+        static constexpr Weight FIRST_WEIGHT{};
+
+        void InitializeArcs(ArcLists& out_arcs, ArcLists& in_arcs) const;
+        void AddShortcut(ArcLists& out_arcs, ArcLists& in_arcs, Shortcut shortcut);
+        void Contract();
+        size_t ContractVertex(ArcLists& out_arcs, ArcLists& in_arcs, const std::vector<bool>& contracted,
+            VertexId vertex, bool simulate);
+        void BuildSearchArcs(const ArcLists& out_arcs);
+        void UnpackEdge(EdgeId edge, std::vector<EdgeId>& edges) const;
+
+        const Graph& graph_;
+        std::vector<size_t> ranks_;
+        std::vector<Shortcut> shortcuts_;
+
+        // рёбра к вершинам с большим рангом: прямые для поиска от from,
+        // обращённые для поиска от to
+        std::vector<std::vector<Arc>> upward_arcs_;
+        std::vector<std::vector<Arc>> downward_arcs_;
+
+        // буферы поиска свидетелей, переиспользуются между вызовами
+        std::vector<std::optional<Weight>> witness_weights_;
+        std::vector<VertexId> witness_touched_;
+
+        struct Label {
+            std::optional<Weight> weight;
+            std::optional<EdgeId> prev_edge;
+            VertexId prev_vertex = 0;
+        };
+
+        // концы ребра графа или шортката
+        std::pair<VertexId, VertexId> GetEdgeEnds(EdgeId edge) const;
+    };
+
+    template <typename Weight>
+    ContractionHierarchy<Weight>::ContractionHierarchy(const Graph& graph)
+        : graph_(graph)
+        , ranks_(graph.GetVertexCount())
+    {
+        for (const auto& edge : graph_.GetEdges()) {
+            if (edge.weight < FIRST_WEIGHT) {
+                throw std::domain_error("Edges' weights should be non-negative");
+            }
+        }
+        Contract();
+    }
+
+    template <typename Weight>
+    ContractionHierarchy<Weight>::ContractionHierarchy(const Graph& graph, std::vector<size_t> ranks,
+        std::vector<Shortcut> shortcuts)
+        : graph_(graph)
+        , ranks_(std::move(ranks))
+    {
+        if (ranks_.size() != graph_.GetVertexCount()) {
+            throw std::invalid_argument("Ranks don't match the graph");
+        }
+
+        ArcLists out_arcs;
+        ArcLists in_arcs;
+        InitializeArcs(out_arcs, in_arcs);
+        const size_t vertex_count = graph_.GetVertexCount();
+        shortcuts_.reserve(shortcuts.size());
+        for (auto& shortcut : shortcuts) {
+            const EdgeId edge_id = graph_.GetEdgeCount() + shortcuts_.size();
+            if (shortcut.from >= vertex_count || shortcut.to >= vertex_count
+                || shortcut.first_edge >= edge_id || shortcut.second_edge >= edge_id || shortcut.weight < FIRST_WEIGHT) {
+                throw std::invalid_argument("Shortcuts don't match the graph");
+            }
+            // путь from -> middle -> to: иначе распаковка даст разорванный маршрут
+            const auto [first_from, first_to] = GetEdgeEnds(shortcut.first_edge);
+            const auto [second_from, second_to] = GetEdgeEnds(shortcut.second_edge);
+            if (first_from != shortcut.from || first_to != second_from || second_to != shortcut.to) {
+                throw std::invalid_argument("Shortcuts don't match the graph");
+            }
+            AddShortcut(out_arcs, in_arcs, std::move(shortcut));
+        }
+        BuildSearchArcs(out_arcs);
+    }
+
+    template <typename Weight>
+    const std::vector<size_t>& ContractionHierarchy<Weight>::GetRanks() const {
+        return ranks_;
+    }
+
+    template <typename Weight>
+    const std::vector<typename ContractionHierarchy<Weight>::Shortcut>& ContractionHierarchy<Weight>::GetShortcuts() const {
+        return shortcuts_;
+    }
+
+    template <typename Weight>
+    void ContractionHierarchy<Weight>::InitializeArcs(ArcLists& out_arcs, ArcLists& in_arcs) const {
+        const size_t vertex_count = graph_.GetVertexCount();
+        out_arcs.assign(vertex_count, {});
+        in_arcs.assign(vertex_count, {});
+
+        // из кратных рёбер оставляем самое лёгкое, петли для кратчайших путей не нужны
+        for (EdgeId edge_id = 0; edge_id < graph_.GetEdgeCount(); ++edge_id) {
+            const auto& edge = graph_.GetEdge(edge_id);
+            if (edge.from == edge.to) {
+                continue;
+            }
+            auto& arcs = out_arcs[edge.from];
+            auto it = std::find_if(arcs.begin(), arcs.end(),
+                [&edge](const Arc& arc) { return arc.vertex == edge.to; });
+            if (it == arcs.end()) {
+                arcs.push_back({ edge.to, edge.weight, edge_id });
+            }
+            else if (edge.weight < it->weight) {
+                *it = { edge.to, edge.weight, edge_id };
+            }
+        }
+
+        for (VertexId from = 0; from < vertex_count; ++from) {
+            for (const Arc& arc : out_arcs[from]) {
+                in_arcs[arc.vertex].push_back({ from, arc.weight, arc.edge });
+            }
+        }
+    }
+
+    template <typename Weight>
+    void ContractionHierarchy<Weight>::AddShortcut(ArcLists& out_arcs, ArcLists& in_arcs, Shortcut shortcut) {
+        const EdgeId edge_id = graph_.GetEdgeCount() + shortcuts_.size();
+
+        auto update = [&](std::vector<Arc>& arcs, VertexId vertex) {
+            auto it = std::find_if(arcs.begin(), arcs.end(),
+                [vertex](const Arc& arc) { return arc.vertex == vertex; });
+            if (it == arcs.end()) {
+                arcs.push_back({ vertex, shortcut.weight, edge_id });
+            }
+            else {
+                *it = { vertex, shortcut.weight, edge_id };
+            }
+        };
+        update(out_arcs.at(shortcut.from), shortcut.to);
+        update(in_arcs.at(shortcut.to), shortcut.from);
+
+        shortcuts_.push_back(std::move(shortcut));
+    }
+
+    template <typename Weight>
+    void ContractionHierarchy<Weight>::Contract() {
+        const size_t vertex_count = graph_.GetVertexCount();
+
+        ArcLists out_arcs;
+        ArcLists in_arcs;
+        InitializeArcs(out_arcs, in_arcs);
+
+        witness_weights_.assign(vertex_count, std::nullopt);
+        std::vector<bool> contracted(vertex_count, false);
+        std::vector<int> contracted_neighbors(vertex_count, 0);
+
+        auto priority = [&](VertexId vertex) {
+            const int shortcuts = static_cast<int>(ContractVertex(out_arcs, in_arcs, contracted, vertex, true));
+            auto is_active = [&contracted](const Arc& arc) { return !contracted[arc.vertex]; };
+            const int removed = static_cast<int>(
+                std::count_if(out_arcs[vertex].begin(), out_arcs[vertex].end(), is_active)
+                + std::count_if(in_arcs[vertex].begin(), in_arcs[vertex].end(), is_active));
+            return shortcuts - removed + contracted_neighbors[vertex];
+        };
+
+        using PriorityItem = std::pair<int, VertexId>;
+        std::priority_queue<PriorityItem, std::vector<PriorityItem>, std::greater<PriorityItem>> queue;
+        for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+            queue.push({ priority(vertex), vertex });
+        }
+
+        size_t rank = 0;
+        while (!queue.empty()) {
+            const VertexId vertex = queue.top().second;
+            queue.pop();
+            if (contracted[vertex]) {
+                continue;
+            }
+
+            // ленивое обновление: приоритет мог устареть после сжатия соседей
+            const int actual_priority = priority(vertex);
+            if (!queue.empty() && actual_priority > queue.top().first) {
+                queue.push({ actual_priority, vertex });
+                continue;
+            }
+
+            ContractVertex(out_arcs, in_arcs, contracted, vertex, false);
+            contracted[vertex] = true;
+            ranks_[vertex] = rank++;
+
+            for (const Arc& arc : out_arcs[vertex]) {
+                ++contracted_neighbors[arc.vertex];
+            }
+            for (const Arc& arc : in_arcs[vertex]) {
+                ++contracted_neighbors[arc.vertex];
+            }
+        }
+
+        witness_weights_.clear();
+        witness_weights_.shrink_to_fit();
+        witness_touched_.clear();
+        witness_touched_.shrink_to_fit();
+
+        BuildSearchArcs(out_arcs);
+    }
+
+    template <typename Weight>
+    size_t ContractionHierarchy<Weight>::ContractVertex(ArcLists& out_arcs, ArcLists& in_arcs,
+        const std::vector<bool>& contracted, VertexId vertex, bool simulate) {
+        std::vector<Shortcut> shortcuts;
+
+        // копии списков: при добавлении шорткатов списки соседей меняются
+        const std::vector<Arc> incoming = in_arcs[vertex];
+        const std::vector<Arc> outgoing = out_arcs[vertex];
+
+        for (const Arc& in_arc : incoming) {
+            const VertexId from = in_arc.vertex;
+            if (contracted[from]) {
+                continue;
+            }
+
+            std::optional<Weight> max_weight;
+            for (const Arc& out_arc : outgoing) {
+                if (contracted[out_arc.vertex] || out_arc.vertex == from) {
+                    continue;
+                }
+                const Weight via_weight = in_arc.weight + out_arc.weight;
+                if (!max_weight || *max_weight < via_weight) {
+                    max_weight = via_weight;
+                }
+            }
+            if (!max_weight) {
+                continue;
+            }
+
+            // поиск свидетеля: путь from -> to в оставшемся графе в обход vertex
+            Queue queue;
+            witness_weights_[from] = FIRST_WEIGHT;
+            witness_touched_.push_back(from);
+            queue.push({ FIRST_WEIGHT, from });
+            size_t settled = 0;
+            while (!queue.empty() && settled < WITNESS_SETTLE_LIMIT) {
+                const auto [weight, current] = queue.top();
+                queue.pop();
+                if (*witness_weights_[current] < weight) {
+                    continue;
+                }
+                if (*max_weight < weight) {
+                    break;
+                }
+                ++settled;
+                for (const Arc& arc : out_arcs[current]) {
+                    if (contracted[arc.vertex] || arc.vertex == vertex) {
+                        continue;
+                    }
+                    const Weight candidate_weight = weight + arc.weight;
+                    auto& target_weight = witness_weights_[arc.vertex];
+                    if (!target_weight || candidate_weight < *target_weight) {
+                        if (!target_weight) {
+                            witness_touched_.push_back(arc.vertex);
+                        }
+                        target_weight = candidate_weight;
+                        queue.push({ candidate_weight, arc.vertex });
+                    }
+                }
+            }
+
+            for (const Arc& out_arc : outgoing) {
+                if (contracted[out_arc.vertex] || out_arc.vertex == from) {
+                    continue;
+                }
+                const Weight via_weight = in_arc.weight + out_arc.weight;
+                const auto& witness_weight = witness_weights_[out_arc.vertex];
+                if (!witness_weight || via_weight < *witness_weight) {
+                    shortcuts.push_back({ from, out_arc.vertex, via_weight, in_arc.edge, out_arc.edge });
+                }
+            }
+
+            for (const VertexId touched : witness_touched_) {
+                witness_weights_[touched] = std::nullopt;
+            }
+            witness_touched_.clear();
+        }
+
+        if (!simulate) {
+            for (auto& shortcut : shortcuts) {
+                AddShortcut(out_arcs, in_arcs, std::move(shortcut));
+            }
+        }
+        return shortcuts.size();
+    }
+
+    template <typename Weight>
+    void ContractionHierarchy<Weight>::BuildSearchArcs(const ArcLists& out_arcs) {
+        const size_t vertex_count = graph_.GetVertexCount();
+        upward_arcs_.assign(vertex_count, {});
+        downward_arcs_.assign(vertex_count, {});
+
+        for (VertexId from = 0; from < vertex_count; ++from) {
+            for (const Arc& arc : out_arcs[from]) {
+                if (ranks_[from] < ranks_[arc.vertex]) {
+                    upward_arcs_[from].push_back(arc);
+                }
+                else {
+                    downward_arcs_[arc.vertex].push_back({ from, arc.weight, arc.edge });
+                }
+            }
+        }
+    }
+
+    template <typename Weight>
+    void ContractionHierarchy<Weight>::UnpackEdge(EdgeId edge, std::vector<EdgeId>& edges) const {
+        std::vector<EdgeId> stack{ edge };
+        while (!stack.empty()) {
+            const EdgeId current = stack.back();
+            stack.pop_back();
+            if (current < graph_.GetEdgeCount()) {
+                edges.push_back(current);
+                continue;
+            }
+            const auto& shortcut = shortcuts_.at(current - graph_.GetEdgeCount());
+            stack.push_back(shortcut.second_edge);
+            stack.push_back(shortcut.first_edge);
+        }
+    }
+
+    template <typename Weight>
+    std::pair<VertexId, VertexId> ContractionHierarchy<Weight>::GetEdgeEnds(EdgeId edge) const {
+        if (edge < graph_.GetEdgeCount()) {
+            const auto& graph_edge = graph_.GetEdge(edge);
+            return { graph_edge.from, graph_edge.to };
+        }
+        const auto& shortcut = shortcuts_.at(edge - graph_.GetEdgeCount());
+        return { shortcut.from, shortcut.to };
+    }
+
+    template <typename Weight>
+    std::optional<typename ContractionHierarchy<Weight>::RouteInfo> ContractionHierarchy<Weight>::BuildRoute(VertexId from,
+        VertexId to) const {
+        const size_t vertex_count = graph_.GetVertexCount();
+        if (from >= vertex_count || to >= vertex_count) {
+            throw std::out_of_range("Vertex id is out of range");
+        }
+        if (from == to) {
+            return RouteInfo{ FIRST_WEIGHT, {} };
+        }
+
+        // метки прямого и обратного поиска
+        std::vector<Label> labels[2] = { std::vector<Label>(vertex_count), std::vector<Label>(vertex_count) };
+
+        Queue queues[2];
+        const std::vector<std::vector<Arc>>* arcs[2] = { &upward_arcs_, &downward_arcs_ };
+
+        labels[0][from] = { FIRST_WEIGHT, std::nullopt, from };
+        labels[1][to] = { FIRST_WEIGHT, std::nullopt, to };
+        queues[0].push({ FIRST_WEIGHT, from });
+        queues[1].push({ FIRST_WEIGHT, to });
+
+        std::optional<Weight> best_weight;
+        VertexId meeting_vertex = from;
+
+        while (!queues[0].empty() || !queues[1].empty()) {
+            for (size_t direction = 0; direction < 2; ++direction) {
+                auto& queue = queues[direction];
+                if (queue.empty()) {
+                    continue;
+                }
+                const auto [weight, vertex] = queue.top();
+                queue.pop();
+                if (*labels[direction][vertex].weight < weight) {
+                    continue;
+                }
+                // в этом направлении уже не найти пути короче найденного
+                if (best_weight && !(weight < *best_weight)) {
+                    queue = Queue{};
+                    continue;
+                }
+
+                if (const auto& other_weight = labels[1 - direction][vertex].weight) {
+                    const Weight total_weight = weight + *other_weight;
+                    if (!best_weight || total_weight < *best_weight) {
+                        best_weight = total_weight;
+                        meeting_vertex = vertex;
+                    }
+                }
+
+                // stall-on-demand: если в вершину можно прийти короче сверху,
+                // кратчайший путь через неё не проходит и рёбра не релаксируются
+                const bool stalled = std::any_of((*arcs[1 - direction])[vertex].begin(), (*arcs[1 - direction])[vertex].end(),
+                    [&](const Arc& arc) {
+                        const auto& arc_weight = labels[direction][arc.vertex].weight;
+                        return arc_weight && *arc_weight + arc.weight < weight;
+                    });
+                if (stalled) {
+                    continue;
+                }
+
+                for (const Arc& arc : (*arcs[direction])[vertex]) {
+                    const Weight candidate_weight = weight + arc.weight;
+                    auto& label = labels[direction][arc.vertex];
+                    if (!label.weight || candidate_weight < *label.weight) {
+                        label = { candidate_weight, arc.edge, vertex };
+                        queue.push({ candidate_weight, arc.vertex });
+                    }
+                }
+            }
+        }
+
+        std::vector<EdgeId> path;
+        if (best_weight) {
+            for (VertexId vertex = meeting_vertex; labels[0][vertex].prev_edge; vertex = labels[0][vertex].prev_vertex) {
+                path.push_back(*labels[0][vertex].prev_edge);
+            }
+            std::reverse(path.begin(), path.end());
+            for (VertexId vertex = meeting_vertex; labels[1][vertex].prev_edge; vertex = labels[1][vertex].prev_vertex) {
+                path.push_back(*labels[1][vertex].prev_edge);
+            }
+        }
+
+        if (!best_weight) {
+            return std::nullopt;
+        }
+
+        std::vector<EdgeId> edges;
+        for (const EdgeId edge : path) {
+            UnpackEdge(edge, edges);
+        }
+
+        return RouteInfo{ *best_weight, std::move(edges) };
+    }
+
+}  // namespace graph
@@ -0,0 +1,315 @@
+#pragma once
+
+#include "router.h"
+
+#include <algorithm>
+#include <functional>
+#include <optional>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+    // Маршрутизатор без предподсчёта: каждый запрос решается поиском Дейкстры
+    // из вершины from с досрочной остановкой при извлечении вершины to.
+    // Память O(V + E) вместо O(V^2) у Router, запуск за O(E) вместо O(V^3).
+    // С потенциалом поиск превращается в A* и раскрывает только вершины между from и to.
+    template <typename Weight>
+    class DijkstraRouter {
+    private:
+        using Graph = DirectedWeightedGraph<Weight>;
+
+    public:
+        using RouteInfo = typename Router<Weight>::RouteInfo;
+
+        explicit DijkstraRouter(const Graph& graph);
+
+        std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const;
+
+        // potential(v) - нижняя оценка веса пути из v в to; оценка должна быть согласованной:
+        // potential(u) <= edge.weight + potential(v) для каждого ребра u -> v, иначе путь может быть не кратчайшим
+        template <typename Potential>
+        std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to, const Potential& potential) const;
+
+        // Поиск навстречу: прямой из from по исходящим рёбрам и обратный из to по входящим,
+        // каждый раз продвигается тот, у кого меньше вес в начале очереди. Поиски останавливаются,
+        // когда сумма этих весов не меньше лучшего найденного пути, и обычно раскрывают
+        // вдвое меньше вершин, чем BuildRoute. Путь восстанавливается в том же виде, что у Router
+        std::optional<RouteInfo> BuildRouteBidirectional(VertexId from, VertexId to) const;
+
+        // веса кратчайших путей из from до каждой из targets за один поиск; nullopt - пути нет.
+        // Поиск останавливается, как только извлечены все цели
+        std::vector<std::optional<Weight>> BuildRouteWeights(VertexId from, const std::vector<VertexId>& targets) const;
+
+        // все вершины, путь до которых из from не тяжелее max_weight, в порядке извлечения;
+        // вершины дальше границы не раскрываются
+        std::vector<std::pair<VertexId, Weight>> BuildRouteWeightsWithin(VertexId from, const Weight& max_weight) const;
+
+    private:
+        struct QueueItem {
+            Weight weight;// вес до вершины плюс потенциал
+            VertexId vertex;
+
+            bool operator>(const QueueItem& other) const {
+                return weight > other.weight;
+            }
+        };
+
+        struct SearchState {
+            explicit SearchState(size_t vertex_count)
+                : weights(vertex_count)
+                , prev_edges(vertex_count)
+                , settled(vertex_count, false) {
+            }
+
+            std::vector<std::optional<Weight>> weights;
+            std::vector<std::optional<EdgeId>> prev_edges;
+            std::vector<bool> settled;
+        };
+
+        // is_done(vertex) вызывается для каждой извлечённой вершины и прекращает поиск, вернув true
+        template <typename Potential, typename StopCondition>
+        void Search(VertexId from, const Potential& potential, const StopCondition& is_done, SearchState& state) const;
+
+        static constexpr Weight FIRST_WEIGHT{};
+        const Graph& graph_;
+    };
+
+    template <typename Weight>
+    DijkstraRouter<Weight>::DijkstraRouter(const Graph& graph)
+        : graph_(graph)
+    {
+        for (const auto& edge : graph_.GetEdges()) {
+            if (edge.weight < FIRST_WEIGHT) {
+                throw std::domain_error("Edges' weights should be non-negative");
+            }
+        }
+    }
+
+    template <typename Weight>
+    std::optional<typename DijkstraRouter<Weight>::RouteInfo> DijkstraRouter<Weight>::BuildRoute(VertexId from,
+        VertexId to) const {
+        return BuildRoute(from, to, [](VertexId) { return FIRST_WEIGHT; });
+    }
+
+    template <typename Weight>
+    template <typename Potential>
+    std::optional<typename DijkstraRouter<Weight>::RouteInfo> DijkstraRouter<Weight>::BuildRoute(VertexId from,
+        VertexId to, const Potential& potential) const {
+        const size_t vertex_count = graph_.GetVertexCount();
+        if (from >= vertex_count || to >= vertex_count) {
+            throw std::out_of_range("Vertex id is out of range");
+        }
+
+        SearchState state(vertex_count);
+        Search(from, potential, [to](VertexId vertex) { return vertex == to; }, state);
+
+        if (!state.weights[to]) {
+            return std::nullopt;
+        }
+
+        std::vector<EdgeId> edges;
+        for (std::optional<EdgeId> edge_id = state.prev_edges[to];
+            edge_id;
+            edge_id = state.prev_edges[graph_.GetEdge(*edge_id).from])
+        {
+            edges.push_back(*edge_id);
+        }
+        std::reverse(edges.begin(), edges.end());
+
+        return RouteInfo{ *state.weights[to], std::move(edges) };
+    }
+
+    template <typename Weight>
+    std::optional<typename DijkstraRouter<Weight>::RouteInfo> DijkstraRouter<Weight>::BuildRouteBidirectional(VertexId from,
+        VertexId to) const {
+        const size_t vertex_count = graph_.GetVertexCount();
+        if (from >= vertex_count || to >= vertex_count) {
+            throw std::out_of_range("Vertex id is out of range");
+        }
+        if (from == to) {
+            return RouteInfo{ FIRST_WEIGHT, {} };
+        }
+
+        using Queue = std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>>;
+        // 0 - прямой поиск, в prev_edges ребро, по которому пришли в вершину;
+        // 1 - обратный, в prev_edges ребро, по которому из вершины идут дальше к to
+        SearchState states[2] = { SearchState(vertex_count), SearchState(vertex_count) };
+        Queue queues[2];
+        states[0].weights[from] = FIRST_WEIGHT;
+        states[1].weights[to] = FIRST_WEIGHT;
+        queues[0].push({ FIRST_WEIGHT, from });
+        queues[1].push({ FIRST_WEIGHT, to });
+
+        const auto& graph_edges = graph_.GetEdges();
+        std::optional<Weight> best_weight;
+        VertexId meeting_vertex = from;
+        while (!queues[0].empty() && !queues[1].empty()) {
+            // в очередях лежат все непросмотренные вершины с их текущими весами,
+            // поэтому путь через них не может быть короче суммы весов в начале очередей
+            if (best_weight && !(queues[0].top().weight + queues[1].top().weight < *best_weight)) {
+                break;
+            }
+            const size_t direction = queues[1].top().weight < queues[0].top().weight ? 1 : 0;
+            SearchState& state = states[direction];
+            const SearchState& other_state = states[1 - direction];
+            const VertexId vertex = queues[direction].top().vertex;
+            queues[direction].pop();
+            if (state.settled[vertex]) {
+                continue;
+            }
+            state.settled[vertex] = true;
+
+            auto relax = [&](EdgeId edge_id, VertexId next_vertex) {
+                if (state.settled[next_vertex]) {
+                    return;
+                }
+                const Weight candidate_weight = *state.weights[vertex] + graph_edges[edge_id].weight;
+                if (state.weights[next_vertex] && !(candidate_weight < *state.weights[next_vertex])) {
+                    return;
+                }
+                state.weights[next_vertex] = candidate_weight;
+                state.prev_edges[next_vertex] = edge_id;
+                queues[direction].push({ candidate_weight, next_vertex });
+                if (other_state.weights[next_vertex]) {
+                    const Weight weight = candidate_weight + *other_state.weights[next_vertex];
+                    if (!best_weight || weight < *best_weight) {
+                        best_weight = weight;
+                        meeting_vertex = next_vertex;
+                    }
+                }
+            };
+            if (direction == 0) {
+                for (const EdgeId edge_id : graph_.GetIncidentEdges(vertex)) {
+                    relax(edge_id, graph_edges[edge_id].to);
+                }
+            }
+            else {
+                for (const EdgeId edge_id : graph_.GetIncomingEdges(vertex)) {
+                    relax(edge_id, graph_edges[edge_id].from);
+                }
+            }
+        }
+
+        if (!best_weight) {
+            return std::nullopt;
+        }
+
+        std::vector<EdgeId> edges;
+        for (std::optional<EdgeId> edge_id = states[0].prev_edges[meeting_vertex];
+            edge_id;
+            edge_id = states[0].prev_edges[graph_.GetEdge(*edge_id).from])
+        {
+            edges.push_back(*edge_id);
+        }
+        std::reverse(edges.begin(), edges.end());
+        for (std::optional<EdgeId> edge_id = states[1].prev_edges[meeting_vertex];
+            edge_id;
+            edge_id = states[1].prev_edges[graph_.GetEdge(*edge_id).to])
+        {
+            edges.push_back(*edge_id);
+        }
+
+        // вес пересчитывается вдоль пути в том же порядке сложения, что у поиска из from
+        Weight weight = FIRST_WEIGHT;
+        for (const EdgeId edge_id : edges) {
+            weight = weight + graph_edges[edge_id].weight;
+        }
+        return RouteInfo{ weight, std::move(edges) };
+    }
+
+    template <typename Weight>
+    std::vector<std::optional<Weight>> DijkstraRouter<Weight>::BuildRouteWeights(VertexId from,
+        const std::vector<VertexId>& targets) const {
+        const size_t vertex_count = graph_.GetVertexCount();
+        if (from >= vertex_count) {
+            throw std::out_of_range("Vertex id is out of range");
+        }
+
+        std::vector<bool> is_target(vertex_count, false);
+        size_t targets_left = 0;
+        for (const VertexId target : targets) {
+            if (target >= vertex_count) {
+                throw std::out_of_range("Vertex id is out of range");
+            }
+            if (!is_target[target]) {
+                is_target[target] = true;
+                ++targets_left;
+            }
+        }
+
+        SearchState state(vertex_count);
+        if (targets_left > 0) {
+            Search(from, [](VertexId) { return FIRST_WEIGHT; },
+                [&is_target, &targets_left](VertexId vertex) { return is_target[vertex] && --targets_left == 0; }, state);
+        }
+
+        std::vector<std::optional<Weight>> result;
+        result.reserve(targets.size());
+        for (const VertexId target : targets) {
+            result.push_back(state.weights[target]);
+        }
+        return result;
+    }
+
+    template <typename Weight>
+    std::vector<std::pair<VertexId, Weight>> DijkstraRouter<Weight>::BuildRouteWeightsWithin(VertexId from,
+        const Weight& max_weight) const {
+        const size_t vertex_count = graph_.GetVertexCount();
+        if (from >= vertex_count) {
+            throw std::out_of_range("Vertex id is out of range");
+        }
+
+        std::vector<std::pair<VertexId, Weight>> result;
+        SearchState state(vertex_count);
+        Search(from, [](VertexId) { return FIRST_WEIGHT; },
+            [&result, &state, &max_weight](VertexId vertex) {
+                const Weight& weight = *state.weights[vertex];
+                if (max_weight < weight) {
+                    return true;
+                }
+                result.emplace_back(vertex, weight);
+                return false;
+            }, state);
+        return result;
+    }
+
+    template <typename Weight>
+    template <typename Potential, typename StopCondition>
+    void DijkstraRouter<Weight>::Search(VertexId from, const Potential& potential, const StopCondition& is_done,
+        SearchState& state) const {
+        std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>> queue;
+
+        const auto& graph_edges = graph_.GetEdges();
+        state.weights[from] = FIRST_WEIGHT;
+        queue.push({ FIRST_WEIGHT + potential(from), from });
+
+        while (!queue.empty()) {
+            const VertexId vertex = queue.top().vertex;
+            queue.pop();
+            if (state.settled[vertex]) {
+                continue;
+            }
+            state.settled[vertex] = true;
+            if (is_done(vertex)) {
+                break;
+            }
+
+            for (const EdgeId edge_id : graph_.GetIncidentEdges(vertex)) {
+                const auto& edge = graph_edges[edge_id];
+                if (state.settled[edge.to]) {
+                    continue;
+                }
+                const Weight candidate_weight = *state.weights[vertex] + edge.weight;
+                if (!state.weights[edge.to] || candidate_weight < *state.weights[edge.to]) {
+                    state.weights[edge.to] = candidate_weight;
+                    state.prev_edges[edge.to] = edge_id;
+                    queue.push({ candidate_weight + potential(edge.to), edge.to });
+                }
+            }
+        }
+    }
+
+}  // namespace graph
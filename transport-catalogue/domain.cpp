@@ -11,21 +11,23 @@ BusInfo::BusInfo(size_t s, size_t u_s, double l, double c)
 	, route_curvature(c)
 {}
 
-StopInfo::StopInfo(std::string_view n, std::vector<Bus*> b)
+StopInfo::StopInfo(std::string_view n, std::vector<const Bus*> b)
 	:name(n),
 	bus_on_route(std::move(b))
 {}
 
-Bus::Bus(std::string_view n, std::vector<Stop*> v, bool is_round)
+Bus::Bus(std::string_view n, std::vector<Stop*> v, bool is_round, uint32_t i)
 	: name(std::string(n))
 	, stop_on_route(v)
 	, is_roundtrip(is_round)
+	, id(i)
 {}
 
-Stop::Stop(std::string_view n, double latit, double longit)
+Stop::Stop(std::string_view n, double latit, double longit, uint32_t i)
 
 	: name(std::string(n))
 	, coordinates(latit, longit)
+	, id(i)
 {}
 
 }//namespace domain
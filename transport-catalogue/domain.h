@@ -1,4 +1,5 @@
 #pragma once
+#include <cstdint>
 #include <string_view>
 #include <string>
 #include <vector>
@@ -12,29 +13,31 @@ namespace domain {
 struct Stop
 {
 	Stop() = default;
-	Stop(std::string_view n, double latit, double longit);
+	Stop(std::string_view n, double latit, double longit, uint32_t i = 0);
 
 	std::string name;
 	geo::Coordinates coordinates;
+	uint32_t id = 0;// номер в каталоге, по порядку добавления
 };
 
 struct Bus
 {
 	Bus() = default;
-	Bus(std::string_view n, std::vector<Stop*> v, bool is_round);
+	Bus(std::string_view n, std::vector<Stop*> v, bool is_round, uint32_t i = 0);
 
 	std::string name;
 	std::vector<Stop*> stop_on_route;
 	bool is_roundtrip;
+	uint32_t id = 0;// номер в каталоге, по порядку добавления
 };
 
 struct StopInfo
 {
 	StopInfo() = default;
-	StopInfo(std::string_view n, std::vector<Bus*> b);
+	StopInfo(std::string_view n, std::vector<const Bus*> b);
 
 	std::string_view name;
-	std::vector<Bus*> bus_on_route;
+	std::vector<const Bus*> bus_on_route;
 };
 
 struct BusInfo
@@ -48,24 +51,6 @@ struct BusInfo
 	double route_curvature;
 };
 
-namespace detail {
-
-	struct PairStopHasher {
-		size_t operator() (const std::pair<Stop*, Stop*> stops) const {
-			return stop_hasher(stops.first) + stop_hasher(stops.second) * 37;
-		}
-
-		std::hash<const void*> stop_hasher;
-	};
-
-	struct BusCmp {
-		bool operator()(Bus* bus_l, Bus* bus_r) const {
-			return bus_r->name > bus_l->name;
-		}
-	};
-
-}//namespace detail
-
 }//namespace domain
 
 }//namespace tc_project
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace container {
+
+    // Хеш-таблица с открытой адресацией и линейным пробированием для 64-битных ключей.
+    // Ключи и значения лежат в двух плоских массивах: ни одного выделения памяти на запись,
+    // поиск - несколько соседних ячеек. Удаления нет. Ключ EMPTY_KEY занят под пустую ячейку.
+    // Указатели на значения действительны до следующей вставки
+    template <typename Value>
+    class FlatHashMap {
+    public:
+        static constexpr uint64_t EMPTY_KEY = std::numeric_limits<uint64_t>::max();
+
+        FlatHashMap() = default;
+
+        // вставляет, если ключа ещё нет; значение по ключу и признак вставки
+        std::pair<Value*, bool> Emplace(uint64_t key, Value value);
+
+        // nullptr, если ключа нет
+        Value* Find(uint64_t key);
+        const Value* Find(uint64_t key) const;
+
+        void Reserve(size_t count);
+        size_t GetSize() const;
+
+    private:
+        static constexpr size_t MIN_CAPACITY = 16;
+
+        // перемешивание splitmix64: соседние номера остановок попадают в далёкие ячейки
+        static uint64_t Mix(uint64_t key);
+
+        // ячейка с ключом или первая пустая на его пути
+        size_t FindSlot(uint64_t key) const;
+
+        void Rehash(size_t capacity);
+
+        std::vector<uint64_t> keys_;// размер - степень двойки, заполнено не больше чем на 3/4
+        std::vector<Value> values_;
+        size_t size_ = 0;
+    };
+
+    template <typename Value>
+    std::pair<Value*, bool> FlatHashMap<Value>::Emplace(uint64_t key, Value value) {
+        if (key == EMPTY_KEY) {
+            throw std::invalid_argument("Key is reserved for empty slots");
+        }
+        if ((size_ + 1) * 4 > keys_.size() * 3) {
+            Rehash(keys_.empty() ? MIN_CAPACITY : keys_.size() * 2);
+        }
+        const size_t slot = FindSlot(key);
+        if (keys_[slot] == key) {
+            return { &values_[slot], false };
+        }
+        keys_[slot] = key;
+        values_[slot] = std::move(value);
+        ++size_;
+        return { &values_[slot], true };
+    }
+
+    template <typename Value>
+    Value* FlatHashMap<Value>::Find(uint64_t key) {
+        return const_cast<Value*>(static_cast<const FlatHashMap&>(*this).Find(key));
+    }
+
+    template <typename Value>
+    const Value* FlatHashMap<Value>::Find(uint64_t key) const {
+        if (keys_.empty() || key == EMPTY_KEY) {
+            return nullptr;
+        }
+        const size_t slot = FindSlot(key);
+        return keys_[slot] == key ? &values_[slot] : nullptr;
+    }
+
+    template <typename Value>
+    void FlatHashMap<Value>::Reserve(size_t count) {
+        size_t capacity = MIN_CAPACITY;
+        while (capacity * 3 < count * 4) {
+            capacity *= 2;
+        }
+        if (capacity > keys_.size()) {
+            Rehash(capacity);
+        }
+    }
+
+    template <typename Value>
+    size_t FlatHashMap<Value>::GetSize() const {
+        return size_;
+    }
+
+    template <typename Value>
+    uint64_t FlatHashMap<Value>::Mix(uint64_t key) {
+        key += 0x9e3779b97f4a7c15ULL;
+        key = (key ^ (key >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        key = (key ^ (key >> 27)) * 0x94d049bb133111ebULL;
+        return key ^ (key >> 31);
+    }
+
+    template <typename Value>
+    size_t FlatHashMap<Value>::FindSlot(uint64_t key) const {
+        const size_t mask = keys_.size() - 1;
+        size_t slot = static_cast<size_t>(Mix(key)) & mask;
+        while (keys_[slot] != key && keys_[slot] != EMPTY_KEY) {
+            slot = (slot + 1) & mask;
+        }
+        return slot;
+    }
+
+    template <typename Value>
+    void FlatHashMap<Value>::Rehash(size_t capacity) {
+        std::vector<uint64_t> old_keys(capacity, EMPTY_KEY);
+        std::vector<Value> old_values(capacity);
+        keys_.swap(old_keys);
+        values_.swap(old_values);
+        for (size_t i = 0; i < old_keys.size(); ++i) {
+            if (old_keys[i] != EMPTY_KEY) {
+                const size_t slot = FindSlot(old_keys[i]);
+                keys_[slot] = old_keys[i];
+                values_[slot] = std::move(old_values[i]);
+            }
+        }
+    }
+
+}  // namespace container
@@ -0,0 +1,121 @@
+#include "flat_hash_map.h"
+#include "test_base.h"
+
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Проверка container::FlatHashMap: до и после каждой перестройки таблицы при вставках
+// поиск должен давать то же, что std::unordered_map, для найденных и отсутствующих ключей
+
+using namespace tc_project;
+using namespace tc_project::test;
+using namespace std::literals;
+
+namespace {
+
+using Map = container::FlatHashMap<unsigned int>;
+
+// ключи как у расстояний между остановками, подряд идущие и крайние значения
+std::vector<uint64_t> MakeKeys(size_t count, uint32_t seed) {
+	std::mt19937_64 generator(seed);
+	std::vector<uint64_t> keys = { 0, 1, Map::EMPTY_KEY - 1, uint64_t{ 1 } << 63 };
+	for (uint64_t from = 0; from < 20; ++from) {
+		for (uint64_t to = 0; to < 20; ++to) {
+			keys.push_back((from << 32) | to);
+		}
+	}
+	while (keys.size() < count) {
+		keys.push_back(generator() % (Map::EMPTY_KEY - 1));
+	}
+	return keys;
+}
+
+// все ключи expected находятся с теми же значениями, а missing - не находятся
+bool IsSame(const Map& map, const std::unordered_map<uint64_t, unsigned int>& expected, const std::vector<uint64_t>& missing) {
+	if (map.GetSize() != expected.size()) {
+		return false;
+	}
+	for (const auto& [key, value] : expected) {
+		const unsigned int* found = map.Find(key);
+		if (!found || *found != value) {
+			return false;
+		}
+	}
+	for (const uint64_t key : missing) {
+		if (!expected.count(key) && map.Find(key)) {
+			return false;
+		}
+	}
+	return !map.Find(Map::EMPTY_KEY);
+}
+
+// таблица заполняется не больше чем на 3/4 и перестраивается при вставке после 3 * 2^k ключей:
+// проверяются размеры перед перестройкой и сразу после неё
+bool IsAroundRehash(size_t size) {
+	const size_t quarter = (size % 3 == 0 ? size : size - 1) / 3;
+	return quarter > 0 && (size % 3 == 0 || size % 3 == 1) && (quarter & (quarter - 1)) == 0;
+}
+
+size_t CheckInserts(Map& map, const std::vector<uint64_t>& keys, const std::vector<uint64_t>& missing) {
+	std::unordered_map<uint64_t, unsigned int> expected;
+	size_t failures = 0;
+	for (size_t i = 0; i < keys.size(); ++i) {
+		const auto value = static_cast<unsigned int>(i);
+		const auto [found, inserted] = map.Emplace(keys[i], value);
+		const auto [expected_it, expected_inserted] = expected.emplace(keys[i], value);
+		// повторная вставка не заменяет значение
+		failures += !Check(inserted == expected_inserted && *found == expected_it->second,
+			"Emplace of key "s + std::to_string(keys[i]) + " returned a wrong value"s);
+		*found += 1;
+		expected_it->second += 1;
+
+		if (IsAroundRehash(expected.size()) || i + 1 == keys.size()) {
+			failures += !Check(IsSame(map, expected, missing), "lookup differs after "s + std::to_string(expected.size()) + " key(s)"s);
+		}
+	}
+	return failures;
+}
+
+}//namespace
+
+int main() {
+	size_t failures = 0;
+
+	const std::vector<uint64_t> keys = MakeKeys(20000, 21);
+	// повторы тех же ключей и ключи, которых в таблице нет
+	std::vector<uint64_t> keys_with_repeats(keys.begin(), keys.end());
+	keys_with_repeats.insert(keys_with_repeats.end(), keys.begin(), keys.begin() + keys.size() / 4);
+	const std::vector<uint64_t> missing = MakeKeys(25000, 2021);
+
+	{
+		Map map;
+		failures += !Check(map.GetSize() == 0 && !map.Find(0) && !map.Find(Map::EMPTY_KEY), "empty map finds a key"s);
+		failures += CheckInserts(map, keys_with_repeats, missing);
+	}
+	{
+		// после Reserve вставки идут без перестройки, результат тот же
+		Map map;
+		map.Reserve(keys.size());
+		failures += CheckInserts(map, keys_with_repeats, missing);
+		const size_t size = map.GetSize();
+		map.Reserve(10);
+		failures += !Check(map.GetSize() == size && map.Find(keys.back()), "smaller Reserve lost keys"s);
+	}
+	{
+		Map map;
+		bool rejected = false;
+		try {
+			map.Emplace(Map::EMPTY_KEY, 1);
+		}
+		catch (const std::invalid_argument&) {
+			rejected = true;
+		}
+		failures += !Check(rejected && map.GetSize() == 0, "EMPTY_KEY wasn't rejected"s);
+	}
+
+	return Finish(failures);
+}
@@ -2,12 +2,17 @@
 
 #include "ranges.h"
 
+#include <cstdint>
 #include <cstdlib>
+#include <limits>
+#include <stdexcept>
+#include <utility>
 #include <vector>
 
 namespace graph {
 
-    using VertexId = size_t;
+    // номера вершин 32-битные: ребро с весом из двух 32-битных полей и double занимает 24 байта
+    using VertexId = uint32_t;
     using EdgeId = size_t;
 
     template <typename Weight>
@@ -17,48 +22,155 @@ namespace graph {
         Weight weight;
     };
 
+    // Рёбра хранятся в одном массиве. После Finalize они упорядочены по вершине from (CSR):
+    // рёбра вершины v имеют номера [offsets_[v], offsets_[v + 1]) и лежат в памяти подряд,
+    // поэтому обход соседей не требует отдельных списков номеров.
+    // Входящие рёбра для обратного поиска - номера, упорядоченные по вершине to, с такими же смещениями.
     template <typename Weight>
     class DirectedWeightedGraph {
     private:
-        using IncidenceList = std::vector<EdgeId>;
-        using IncidentEdgesRange = ranges::Range<typename IncidenceList::const_iterator>;
+        using IncidentEdgesRange = ranges::Range<ranges::CountingIterator<EdgeId>>;
+        using IncomingEdgesRange = ranges::Range<typename std::vector<EdgeId>::const_iterator>;
 
     public:
+        // новый номер удалённого ребра в результатах Finalize и EraseEdges
+        static constexpr EdgeId REMOVED_EDGE = std::numeric_limits<EdgeId>::max();
+
         DirectedWeightedGraph() = default;
         explicit DirectedWeightedGraph(size_t vertex_count);
         EdgeId AddEdge(const Edge<Weight>& edge);
+        // новые вершины без рёбер получают номера от GetVertexCount()
+        void AddVertices(size_t count);
+
+        // Устойчиво упорядочивает рёбра по from и строит смещения. Номера рёбер меняются,
+        // поэтому вызывается до построения маршрутизаторов; для уже упорядоченных рёбер номера сохраняются.
+        // Возвращает новые номера рёбер по старым, чтобы маршрутизаторы могли их пересчитать
+        std::vector<EdgeId> Finalize();
+        bool IsFinalized() const;
+
+        // удаляет рёбра, для которых predicate(edge) истинно, не меняя порядок остальных;
+        // возвращает новые номера рёбер по старым, REMOVED_EDGE для удалённых
+        template <typename Predicate>
+        std::vector<EdgeId> EraseEdges(Predicate predicate);
 
         size_t GetVertexCount() const;
         size_t GetEdgeCount() const;
         const Edge<Weight>& GetEdge(EdgeId edge_id) const;
+        // только для графа после Finalize
         IncidentEdgesRange GetIncidentEdges(VertexId vertex) const;
+        // рёбра с концом в vertex в порядке номеров; только для графа после Finalize
+        IncomingEdgesRange GetIncomingEdges(VertexId vertex) const;
 
+        // после изменения рёбер через неконстантную ссылку нужно снова вызвать Finalize
         std::vector<Edge<Weight>>& GetEdges();
         const std::vector<Edge<Weight>>& GetEdges() const;
-        std::vector<IncidenceList>& GetIncidenceLists();
-        const std::vector<IncidenceList>& GetIncidenceLists() const;
 
     private:
         std::vector<Edge<Weight>> edges_;
-        std::vector<IncidenceList> incidence_lists_;
+        std::vector<EdgeId> offsets_ = std::vector<EdgeId>(1, 0);
+        std::vector<EdgeId> incoming_edges_;
+        std::vector<EdgeId> incoming_offsets_ = std::vector<EdgeId>(1, 0);
+        bool finalized_ = true;
     };
 
     template <typename Weight>
     DirectedWeightedGraph<Weight>::DirectedWeightedGraph(size_t vertex_count)
-        : incidence_lists_(vertex_count) {
+        : offsets_(vertex_count + 1, 0)
+        , incoming_offsets_(vertex_count + 1, 0) {
     }
 
     template <typename Weight>
     EdgeId DirectedWeightedGraph<Weight>::AddEdge(const Edge<Weight>& edge) {
+        if (edge.from >= GetVertexCount()) {
+            throw std::out_of_range("Vertex id is out of range");
+        }
         edges_.push_back(edge);
-        const EdgeId id = edges_.size() - 1;
-        incidence_lists_.at(edge.from).push_back(id);
-        return id;
+        finalized_ = false;
+        return edges_.size() - 1;
+    }
+
+    template <typename Weight>
+    void DirectedWeightedGraph<Weight>::AddVertices(size_t count) {
+        offsets_.insert(offsets_.end(), count, offsets_.back());
+        incoming_offsets_.insert(incoming_offsets_.end(), count, incoming_offsets_.back());
+    }
+
+    template <typename Weight>
+    std::vector<EdgeId> DirectedWeightedGraph<Weight>::Finalize() {
+        const size_t vertex_count = GetVertexCount();
+        offsets_.assign(vertex_count + 1, 0);
+        incoming_offsets_.assign(vertex_count + 1, 0);
+        bool sorted = true;
+        for (size_t i = 0; i < edges_.size(); ++i) {
+            if (edges_[i].from >= vertex_count || edges_[i].to >= vertex_count) {
+                throw std::out_of_range("Vertex id is out of range");
+            }
+            ++offsets_[edges_[i].from + 1];
+            ++incoming_offsets_[edges_[i].to + 1];
+            sorted = sorted && (i == 0 || edges_[i - 1].from <= edges_[i].from);
+        }
+        for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+            offsets_[vertex + 1] += offsets_[vertex];
+            incoming_offsets_[vertex + 1] += incoming_offsets_[vertex];
+        }
+
+        std::vector<EdgeId> new_edge_ids(edges_.size());
+        // сортировка подсчётом, порядок рёбер одной вершины не меняется
+        if (!sorted) {
+            std::vector<EdgeId> next(offsets_.begin(), offsets_.end() - 1);
+            for (EdgeId edge_id = 0; edge_id < edges_.size(); ++edge_id) {
+                new_edge_ids[edge_id] = next[edges_[edge_id].from]++;
+            }
+            std::vector<Edge<Weight>> edges(edges_.size());
+            for (EdgeId edge_id = 0; edge_id < edges_.size(); ++edge_id) {
+                edges[new_edge_ids[edge_id]] = std::move(edges_[edge_id]);
+            }
+            edges_ = std::move(edges);
+        }
+        else {
+            for (EdgeId edge_id = 0; edge_id < edges_.size(); ++edge_id) {
+                new_edge_ids[edge_id] = edge_id;
+            }
+        }
+
+        incoming_edges_.resize(edges_.size());
+        std::vector<EdgeId> next_incoming(incoming_offsets_.begin(), incoming_offsets_.end() - 1);
+        for (EdgeId edge_id = 0; edge_id < edges_.size(); ++edge_id) {
+            incoming_edges_[next_incoming[edges_[edge_id].to]++] = edge_id;
+        }
+        finalized_ = true;
+        return new_edge_ids;
+    }
+
+    template <typename Weight>
+    template <typename Predicate>
+    std::vector<EdgeId> DirectedWeightedGraph<Weight>::EraseEdges(Predicate predicate) {
+        std::vector<EdgeId> new_edge_ids(edges_.size(), REMOVED_EDGE);
+        EdgeId next_edge_id = 0;
+        for (EdgeId edge_id = 0; edge_id < edges_.size(); ++edge_id) {
+            if (!predicate(edges_[edge_id])) {
+                new_edge_ids[edge_id] = next_edge_id;
+                if (next_edge_id != edge_id) {
+                    edges_[next_edge_id] = std::move(edges_[edge_id]);
+                }
+                ++next_edge_id;
+            }
+        }
+        edges_.erase(edges_.begin() + next_edge_id, edges_.end());
+        if (finalized_) {
+            Finalize();
+        }
+        return new_edge_ids;
+    }
+
+    template <typename Weight>
+    bool DirectedWeightedGraph<Weight>::IsFinalized() const {
+        return finalized_;
     }
 
     template <typename Weight>
     size_t DirectedWeightedGraph<Weight>::GetVertexCount() const {
-        return incidence_lists_.size();
+        return offsets_.size() - 1;
     }
 
     template <typename Weight>
@@ -74,7 +186,19 @@ namespace graph {
     template <typename Weight>
     typename DirectedWeightedGraph<Weight>::IncidentEdgesRange
         DirectedWeightedGraph<Weight>::GetIncidentEdges(VertexId vertex) const {
-        return ranges::AsRange(incidence_lists_.at(vertex));
+        if (!finalized_) {
+            throw std::logic_error("Graph should be finalized before traversal");
+        }
+        return { ranges::CountingIterator<EdgeId>(offsets_.at(vertex)), ranges::CountingIterator<EdgeId>(offsets_[vertex + 1]) };
+    }
+
+    template <typename Weight>
+    typename DirectedWeightedGraph<Weight>::IncomingEdgesRange
+        DirectedWeightedGraph<Weight>::GetIncomingEdges(VertexId vertex) const {
+        if (!finalized_) {
+            throw std::logic_error("Graph should be finalized before traversal");
+        }
+        return { incoming_edges_.begin() + incoming_offsets_.at(vertex), incoming_edges_.begin() + incoming_offsets_[vertex + 1] };
     }
 
     template <typename Weight>
@@ -87,14 +211,4 @@ namespace graph {
         return edges_;
     }
 
-    template<typename Weight>
-    std::vector<typename DirectedWeightedGraph<Weight>::IncidenceList>& DirectedWeightedGraph<Weight>::GetIncidenceLists() {
-        return incidence_lists_;
-    }
-
-    template<typename Weight>
-    const std::vector<typename DirectedWeightedGraph<Weight>::IncidenceList>& DirectedWeightedGraph<Weight>::GetIncidenceLists() const {
-        return incidence_lists_;
-    }
-
-}  // namespace graph
\ No newline at end of file
+}  // namespace graph
@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <thread>
 
 #include "json_reader.h"
 
@@ -69,6 +70,14 @@ const json::Node& JesonReader::GetSerializationSettings() const
 	return empty_node_;
 }
 
+const json::Node& JesonReader::GetCacheSettings() const
+{
+	if (input_document_.GetRoot().AsMap().count("cache_settings"s)) {
+		return input_document_.GetRoot().AsMap().at("cache_settings"s);
+	}
+	return empty_node_;
+}
+
 void JesonReader::FiilCatalogue(transport_catalogue::TransportCatalogue& catalogue)
 {
 
@@ -84,6 +93,10 @@ void JesonReader::FiilCatalogue(transport_catalogue::TransportCatalogue& catalog
 		catalogue.AddDistanceFromTo(stop_names.first, stop_names.second, distance_to);
 	}
 
+	catalogue.SortIndexes();
+	catalogue.ComputeBusInfo();
+	catalogue.BuildStopIndex();
+
 } 
 
 void JesonReader::FillRenderProperties(render::RenderProperties& properties)
@@ -116,7 +129,35 @@ void JesonReader::FillRouteProperties(transport_router::TransportRouter& propert
 {
 	const json::Dict route_properties = GetRoutingSettings().AsMap();
 
-	properties.AddRouterSetting({ route_properties.at("bus_wait_time"s).AsDouble(), route_properties.at("bus_velocity"s).AsDouble() });
+	transport_router::RoutingMode routing_mode = transport_router::RoutingMode::ALL_PAIRS;
+	if (route_properties.count("routing_mode"s)) {
+		routing_mode = transport_router::ParseRoutingMode(route_properties.at("routing_mode"s).AsString());
+	}
+
+	size_t thread_count = 1;
+	if (route_properties.count("thread_count"s)) {
+		// 0 -   
+		const int threads = route_properties.at("thread_count"s).AsInt();
+		thread_count = threads > 0 ? threads : std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	transport_router::GraphModel graph_model = transport_router::GraphModel::COMPLETE;
+	if (route_properties.count("graph_model"s)) {
+		graph_model = transport_router::ParseGraphModel(route_properties.at("graph_model"s).AsString());
+	}
+
+	size_t lazy_row_budget = transport_router::DEFAULT_LAZY_ROW_BUDGET;
+	if (route_properties.count("lazy_row_budget"s)) {
+		lazy_row_budget = static_cast<size_t>(std::max(1, route_properties.at("lazy_row_budget"s).AsInt()));
+	}
+
+	size_t landmark_count = transport_router::DEFAULT_LANDMARK_COUNT;
+	if (route_properties.count("landmark_count"s)) {
+		landmark_count = static_cast<size_t>(std::max(1, route_properties.at("landmark_count"s).AsInt()));
+	}
+
+	properties.AddRouterSetting({ route_properties.at("bus_wait_time"s).AsDouble(), route_properties.at("bus_velocity"s).AsDouble(), routing_mode, thread_count,
+		graph_model, lazy_row_budget, landmark_count });
 	properties.InicializeGraph(catalogue);
 
 }
@@ -29,6 +29,7 @@ public:
 	const json::Node& GetRenderProperties() const;
 	const json::Node& GetRoutingSettings() const;
 	const json::Node& GetSerializationSettings() const;
+	const json::Node& GetCacheSettings() const;
 	
 	void FiilCatalogue(transport_catalogue::TransportCatalogue& catalogue);
 	void FillRenderProperties(render::RenderProperties& properties);
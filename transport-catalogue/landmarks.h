@@ -0,0 +1,193 @@
+#pragma once
+
+#include "router.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+    // Ориентиры для A* (ALT): кратчайшие расстояния от K выбранных вершин и до них.
+    // По неравенству треугольника d(v, t) >= d(L, t) - d(L, v) и d(v, t) >= d(v, L) - d(t, L),
+    // максимум таких оценок - согласованный потенциал для DijkstraRouter::BuildRoute.
+    // Память O(K * V) против O(V^2) у Router.
+    template <typename Weight>
+    class Landmarks {
+    private:
+        using Graph = DirectedWeightedGraph<Weight>;
+        using Traits = WeightTraits<Weight>;
+
+    public:
+        using Scalar = typename Traits::Scalar;
+
+        static_assert(std::numeric_limits<Scalar>::has_infinity, "Landmarks need a scalar weight with infinity");
+
+        // ориентиры выбираются по одному: каждый следующий - вершина, дальше всех от уже выбранных
+        Landmarks(const Graph& graph, size_t landmark_count);
+        // таблицы, сохранённые в базе: to_vertex[v * K + k] = d(L_k, v), from_vertex[v * K + k] = d(v, L_k)
+        Landmarks(const Graph& graph, std::vector<VertexId> landmarks, std::vector<Scalar> to_vertex, std::vector<Scalar> from_vertex);
+
+        // нижняя оценка веса пути из from в to; бесконечность, если пути точно нет
+        Weight GetLowerBound(VertexId from, VertexId to) const;
+
+        const std::vector<VertexId>& GetLandmarks() const;
+        const std::vector<Scalar>& GetDistancesToVertices() const;
+        const std::vector<Scalar>& GetDistancesFromVertices() const;
+
+    private:
+        static constexpr Scalar INFINITE_DISTANCE = std::numeric_limits<Scalar>::infinity();
+
+        void SelectLandmarks(size_t landmark_count);
+
+        const Graph& graph_;
+        std::vector<VertexId> landmarks_;
+        std::vector<Scalar> to_vertex_;// по вершинам, внутри - по ориентирам: оценка читает K соседних ячеек
+        std::vector<Scalar> from_vertex_;
+    };
+
+    template <typename Weight>
+    Landmarks<Weight>::Landmarks(const Graph& graph, size_t landmark_count)
+        : graph_(graph)
+    {
+        for (const auto& edge : graph_.GetEdges()) {
+            if (edge.weight < Weight{}) {
+                throw std::domain_error("Edges' weights should be non-negative");
+            }
+        }
+        SelectLandmarks(landmark_count);
+    }
+
+    template <typename Weight>
+    Landmarks<Weight>::Landmarks(const Graph& graph, std::vector<VertexId> landmarks, std::vector<Scalar> to_vertex,
+        std::vector<Scalar> from_vertex)
+        : graph_(graph)
+        , landmarks_(std::move(landmarks))
+        , to_vertex_(std::move(to_vertex))
+        , from_vertex_(std::move(from_vertex))
+    {
+        const size_t cell_count = landmarks_.size() * graph_.GetVertexCount();
+        if (to_vertex_.size() != cell_count || from_vertex_.size() != cell_count) {
+            throw std::invalid_argument("Landmark tables don't match the graph");
+        }
+        for (const VertexId landmark : landmarks_) {
+            if (landmark >= graph_.GetVertexCount()) {
+                throw std::invalid_argument("Landmark tables don't match the graph");
+            }
+        }
+    }
+
+    template <typename Weight>
+    Weight Landmarks<Weight>::GetLowerBound(VertexId from, VertexId to) const {
+        const size_t landmark_count = landmarks_.size();
+        const Scalar* const to_from = to_vertex_.data() + from * landmark_count;
+        const Scalar* const to_to = to_vertex_.data() + to * landmark_count;
+        const Scalar* const from_from = from_vertex_.data() + from * landmark_count;
+        const Scalar* const from_to = from_vertex_.data() + to * landmark_count;
+
+        Scalar bound{};
+        for (size_t k = 0; k < landmark_count; ++k) {
+            // L доезжает до from, но не до to (или to - до L, а from нет): из from в to не попасть
+            if ((to_from[k] != INFINITE_DISTANCE && to_to[k] == INFINITE_DISTANCE)
+                || (from_to[k] != INFINITE_DISTANCE && from_from[k] == INFINITE_DISTANCE)) {
+                return Traits::FromScalar(INFINITE_DISTANCE);
+            }
+            if (to_to[k] != INFINITE_DISTANCE) {
+                bound = std::max(bound, to_to[k] - to_from[k]);
+            }
+            if (from_from[k] != INFINITE_DISTANCE) {
+                bound = std::max(bound, from_from[k] - from_to[k]);
+            }
+        }
+        return Traits::FromScalar(bound);
+    }
+
+    template <typename Weight>
+    const std::vector<VertexId>& Landmarks<Weight>::GetLandmarks() const {
+        return landmarks_;
+    }
+
+    template <typename Weight>
+    const std::vector<typename Landmarks<Weight>::Scalar>& Landmarks<Weight>::GetDistancesToVertices() const {
+        return to_vertex_;
+    }
+
+    template <typename Weight>
+    const std::vector<typename Landmarks<Weight>::Scalar>& Landmarks<Weight>::GetDistancesFromVertices() const {
+        return from_vertex_;
+    }
+
+    template <typename Weight>
+    void Landmarks<Weight>::SelectLandmarks(size_t landmark_count) {
+        using Table = Router<Weight>;
+        const size_t vertex_count = graph_.GetVertexCount();
+
+        // расстояния до ориентира считаются поиском по обращённому графу
+        Graph reversed(vertex_count);
+        std::vector<bool> has_edges(vertex_count, false);
+        reversed.GetEdges().reserve(graph_.GetEdgeCount());
+        for (const auto& edge : graph_.GetEdges()) {
+            reversed.AddEdge({ edge.to, edge.from, edge.weight });
+            has_edges[edge.from] = true;
+            has_edges[edge.to] = true;
+        }
+        reversed.Finalize();
+
+        // вершины без рёбер ничего не оценивают
+        const auto first = std::find(has_edges.begin(), has_edges.end(), true);
+        if (first == has_edges.end()) {
+            return;
+        }
+
+        std::vector<Scalar> row(vertex_count);
+        std::vector<typename Table::EdgeIndex> prev_edges(vertex_count);
+
+        // первый ориентир - самая дальняя достижимая вершина от произвольной стартовой
+        const VertexId start = static_cast<VertexId>(first - has_edges.begin());
+        Table::ComputeRouteRow(graph_, start, row.data(), prev_edges.data());
+        VertexId landmark = start;
+        for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+            if (row[vertex] != INFINITE_DISTANCE && row[landmark] < row[vertex]) {
+                landmark = vertex;
+            }
+        }
+
+        // расстояние от ближайшего выбранного ориентира; вершины, недостижимые ни из одного, - самые дальние
+        std::vector<Scalar> nearest(vertex_count, INFINITE_DISTANCE);
+        std::vector<std::vector<Scalar>> to_rows;
+        std::vector<std::vector<Scalar>> from_rows;
+        while (landmark != vertex_count && landmarks_.size() < landmark_count) {
+            landmarks_.push_back(landmark);
+
+            Table::ComputeRouteRow(graph_, landmark, row.data(), prev_edges.data());
+            for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+                nearest[vertex] = std::min(nearest[vertex], row[vertex]);
+            }
+            to_rows.push_back(row);
+            Table::ComputeRouteRow(reversed, landmark, row.data(), prev_edges.data());
+            from_rows.push_back(row);
+
+            // вершины на нулевом расстоянии, в том числе сами ориентиры, не выбираются
+            landmark = static_cast<VertexId>(vertex_count);
+            for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+                if (has_edges[vertex] && Scalar{} < nearest[vertex]
+                    && (landmark == vertex_count || nearest[landmark] < nearest[vertex])) {
+                    landmark = vertex;
+                }
+            }
+        }
+
+        const size_t count = landmarks_.size();
+        to_vertex_.resize(count * vertex_count);
+        from_vertex_.resize(count * vertex_count);
+        for (size_t k = 0; k < count; ++k) {
+            for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+                to_vertex_[vertex * count + k] = to_rows[k][vertex];
+                from_vertex_[vertex * count + k] = from_rows[k][vertex];
+            }
+        }
+    }
+
+}  // namespace graph
@@ -0,0 +1,146 @@
+#pragma once
+
+#include "lru_cache.h"
+#include "router.h"
+
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+namespace graph {
+
+    // Таблица маршрутов Router, строки которой считаются при первом запросе из вершины.
+    // Запуск за O(1) вместо O(V^3); в памяти не больше row_budget строк по O(V),
+    // давно не использованные строки вытесняются и при следующем запросе считаются заново.
+    // Кэш строк меняется и в константных методах, поэтому объект нельзя делить между потоками
+    template <typename Weight>
+    class LazyRouter {
+    private:
+        using Graph = DirectedWeightedGraph<Weight>;
+        using Table = Router<Weight>;
+        using Traits = WeightTraits<Weight>;
+
+    public:
+        using Scalar = typename Table::Scalar;
+        using EdgeIndex = typename Table::EdgeIndex;
+        using RouteInfo = typename Table::RouteInfo;
+
+        LazyRouter(const Graph& graph, size_t row_budget);
+
+        std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const;
+        std::optional<Weight> GetRouteWeight(VertexId from, VertexId to) const;
+
+        // строки устаревают при любом изменении графа
+        void Clear();
+
+        size_t GetRowBudget() const;
+        size_t GetRowCount() const;
+        size_t GetHits() const;
+        size_t GetMisses() const;
+
+    private:
+        struct Row {
+            std::vector<Scalar> weights;
+            std::vector<EdgeIndex> prev_edges;
+        };
+
+        // строка остаётся живой у вызывающего, даже если кэш её уже вытеснил
+        std::shared_ptr<const Row> GetRow(VertexId from) const;
+
+        const Graph& graph_;
+        mutable cache::LruCache<VertexId, std::shared_ptr<const Row>> rows_;
+    };
+
+    template <typename Weight>
+    LazyRouter<Weight>::LazyRouter(const Graph& graph, size_t row_budget)
+        : graph_(graph)
+        , rows_(row_budget)
+    {
+        if (graph_.GetEdgeCount() >= Table::UNREACHABLE) {
+            throw std::length_error("Too many edges for the route table");
+        }
+        for (const auto& edge : graph_.GetEdges()) {
+            if (edge.weight < Weight{}) {
+                throw std::domain_error("Edges' weights should be non-negative");
+            }
+        }
+    }
+
+    template <typename Weight>
+    std::optional<typename LazyRouter<Weight>::RouteInfo> LazyRouter<Weight>::BuildRoute(VertexId from,
+        VertexId to) const {
+        const size_t vertex_count = graph_.GetVertexCount();
+        if (from >= vertex_count || to >= vertex_count) {
+            throw std::out_of_range("Vertex id is out of range");
+        }
+        const auto row = GetRow(from);
+        if (row->prev_edges[to] == Table::UNREACHABLE) {
+            return std::nullopt;
+        }
+        std::vector<EdgeId> edges;
+        for (EdgeIndex edge_id = row->prev_edges[to];
+            edge_id != Table::NO_EDGE;
+            edge_id = row->prev_edges[graph_.GetEdge(edge_id).from])
+        {
+            edges.push_back(edge_id);
+        }
+        std::reverse(edges.begin(), edges.end());
+
+        return RouteInfo{ Traits::FromScalar(row->weights[to]), std::move(edges) };
+    }
+
+    template <typename Weight>
+    std::optional<Weight> LazyRouter<Weight>::GetRouteWeight(VertexId from, VertexId to) const {
+        const size_t vertex_count = graph_.GetVertexCount();
+        if (from >= vertex_count || to >= vertex_count) {
+            throw std::out_of_range("Vertex id is out of range");
+        }
+        const auto row = GetRow(from);
+        if (row->prev_edges[to] == Table::UNREACHABLE) {
+            return std::nullopt;
+        }
+        return Traits::FromScalar(row->weights[to]);
+    }
+
+    template <typename Weight>
+    void LazyRouter<Weight>::Clear() {
+        rows_.Clear();
+    }
+
+    template <typename Weight>
+    size_t LazyRouter<Weight>::GetRowBudget() const {
+        return rows_.GetCapacity();
+    }
+
+    template <typename Weight>
+    size_t LazyRouter<Weight>::GetRowCount() const {
+        return rows_.GetSize();
+    }
+
+    template <typename Weight>
+    size_t LazyRouter<Weight>::GetHits() const {
+        return rows_.GetHits();
+    }
+
+    template <typename Weight>
+    size_t LazyRouter<Weight>::GetMisses() const {
+        return rows_.GetMisses();
+    }
+
+    template <typename Weight>
+    std::shared_ptr<const typename LazyRouter<Weight>::Row> LazyRouter<Weight>::GetRow(VertexId from) const {
+        if (const auto* cached = rows_.Find(from)) {
+            return *cached;
+        }
+        const size_t vertex_count = graph_.GetVertexCount();
+        auto row = std::make_shared<Row>();
+        row->weights.resize(vertex_count);
+        row->prev_edges.resize(vertex_count);
+        Table::ComputeRouteRow(graph_, from, row->weights.data(), row->prev_edges.data());
+        rows_.Insert(from, row);
+        return row;
+    }
+
+}  // namespace graph
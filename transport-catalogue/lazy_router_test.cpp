@@ -0,0 +1,115 @@
+#include "lazy_router.h"
+#include "test_base.h"
+
+#include <algorithm>
+#include <list>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+// Проверка graph::LazyRouter с маленьким бюджетом строк: строки вытесняются, но маршруты совпадают
+// с таблицей всех пар graph::Router, а попадания и промахи - с простой моделью LRU на списке
+
+using namespace tc_project;
+using namespace tc_project::test;
+using namespace std::literals;
+
+namespace {
+
+constexpr size_t STOP_COUNT = 40;
+constexpr size_t BUS_COUNT = 14;
+constexpr size_t ROW_BUDGET = 3;
+constexpr size_t QUERY_COUNT = 3000;
+
+using RouteWeight = transport_router::RouteWeight;
+
+// модель кэша строк: номера вершин от свежих к старым
+class LruModel {
+public:
+	// true, если строка from была в кэше
+	bool Touch(graph::VertexId from) {
+		const auto it = std::find(rows_.begin(), rows_.end(), from);
+		const bool hit = it != rows_.end();
+		if (hit) {
+			rows_.erase(it);
+		}
+		else if (rows_.size() == ROW_BUDGET) {
+			rows_.pop_back();
+		}
+		rows_.push_front(from);
+		return hit;
+	}
+
+	size_t GetSize() const {
+		return rows_.size();
+	}
+
+private:
+	std::list<graph::VertexId> rows_;
+};
+
+}//namespace
+
+int main() {
+	const TestBase base = MakeTestBase(STOP_COUNT, BUS_COUNT, 16);
+
+	size_t failures = 0;
+	for (const std::string& graph_model : { "complete"s, "linear"s }) {
+		transport_catalogue::TransportCatalogue catalogue;
+		transport_router::TransportRouter router;
+		Fill(catalogue, router, base.MakeDocument(MakeRoutingSettings("all_pairs"s, graph_model)));
+		const auto& graph = router.GetGraph();
+		const auto& expected = *router.GetRouter();
+		const size_t vertex_count = graph.GetVertexCount();
+
+		graph::LazyRouter<RouteWeight> lazy_router(graph, ROW_BUDGET);
+		LruModel model;
+
+		// несколько строк по кругу, чтобы вытеснение шло каждый раз, и случайные запросы
+		std::vector<graph::VertexId> sources;
+		for (size_t i = 0; i < QUERY_COUNT / 3; ++i) {
+			sources.push_back(static_cast<graph::VertexId>(i % (ROW_BUDGET + 1)));
+		}
+		std::mt19937 generator(16);
+		while (sources.size() < QUERY_COUNT) {
+			sources.push_back(static_cast<graph::VertexId>(generator() % vertex_count));
+		}
+
+		size_t route_mismatches = 0;
+		size_t cache_mismatches = 0;
+		size_t expected_hits = 0;
+		size_t expected_misses = 0;
+		for (size_t query = 0; query < sources.size(); ++query) {
+			const graph::VertexId from = sources[query];
+			const auto to = static_cast<graph::VertexId>(generator() % vertex_count);
+			if (query % 2 == 0) {
+				route_mismatches += !IsSameRoute(graph, from, to, lazy_router.BuildRoute(from, to), expected.BuildRoute(from, to));
+			}
+			else {
+				const auto weight = lazy_router.GetRouteWeight(from, to);
+				const auto expected_weight = expected.GetRouteWeight(from, to);
+				route_mismatches += weight.has_value() != expected_weight.has_value()
+					|| (weight && !IsSameTime(weight->total_time, expected_weight->total_time));
+			}
+
+			(model.Touch(from) ? expected_hits : expected_misses) += 1;
+			cache_mismatches += lazy_router.GetHits() != expected_hits || lazy_router.GetMisses() != expected_misses
+				|| lazy_router.GetRowCount() != model.GetSize();
+		}
+		failures += !Check(route_mismatches == 0, graph_model + ": "s + std::to_string(route_mismatches) + " route(s) differ from the route table"s);
+		failures += !Check(cache_mismatches == 0, graph_model + ": "s + std::to_string(cache_mismatches) + " query(s) with unexpected hits, misses or rows"s);
+		failures += !Check(lazy_router.GetRowBudget() == ROW_BUDGET && lazy_router.GetRowCount() <= ROW_BUDGET,
+			graph_model + ": "s + "row budget exceeded"s);
+
+		// после Clear строк нет, и следующий запрос снова считает строку
+		lazy_router.Clear();
+		failures += !Check(lazy_router.GetRowCount() == 0, graph_model + ": "s + "Clear left rows in the cache"s);
+		const size_t misses = lazy_router.GetMisses();
+		const bool same_after_clear = IsSameRoute(graph, sources[0], 0, lazy_router.BuildRoute(sources[0], 0), expected.BuildRoute(sources[0], 0));
+		failures += !Check(same_after_clear && lazy_router.GetMisses() == misses + 1,
+			graph_model + ": "s + "the row isn't recomputed after Clear"s);
+	}
+
+	return Finish(failures);
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+namespace cache {
+
+    // Кэш фиксированного размера с вытеснением давно не использованных записей.
+    // Считает попадания и промахи, чтобы размер можно было подобрать по логам.
+    template <typename Key, typename Value, typename Hash = std::hash<Key>>
+    class LruCache {
+    public:
+        explicit LruCache(size_t capacity);
+
+        // nullptr при промахе; найденная запись становится самой свежей
+        const Value* Find(const Key& key);
+        void Insert(Key key, Value value);
+        void Clear();
+
+        size_t GetCapacity() const;
+        size_t GetSize() const;
+        size_t GetHits() const;
+        size_t GetMisses() const;
+
+    private:
+        using Entry = std::pair<Key, Value>;
+        using Entries = std::list<Entry>;
+
+        size_t capacity_;
+        Entries entries_;// от свежих к старым
+        std::unordered_map<Key, typename Entries::iterator, Hash> index_;
+        size_t hits_ = 0;
+        size_t misses_ = 0;
+    };
+
+    template <typename Key, typename Value, typename Hash>
+    LruCache<Key, Value, Hash>::LruCache(size_t capacity)
+        : capacity_(capacity) {
+        index_.reserve(capacity_);
+    }
+
+    template <typename Key, typename Value, typename Hash>
+    const Value* LruCache<Key, Value, Hash>::Find(const Key& key) {
+        auto it = index_.find(key);
+        if (it == index_.end()) {
+            ++misses_;
+            return nullptr;
+        }
+        ++hits_;
+        entries_.splice(entries_.begin(), entries_, it->second);
+        return &it->second->second;
+    }
+
+    template <typename Key, typename Value, typename Hash>
+    void LruCache<Key, Value, Hash>::Insert(Key key, Value value) {
+        if (capacity_ == 0) {
+            return;
+        }
+        if (auto it = index_.find(key); it != index_.end()) {
+            it->second->second = std::move(value);
+            entries_.splice(entries_.begin(), entries_, it->second);
+            return;
+        }
+        if (entries_.size() == capacity_) {
+            index_.erase(entries_.back().first);
+            entries_.pop_back();
+        }
+        entries_.emplace_front(std::move(key), std::move(value));
+        index_.emplace(entries_.front().first, entries_.begin());
+    }
+
+    template <typename Key, typename Value, typename Hash>
+    void LruCache<Key, Value, Hash>::Clear() {
+        entries_.clear();
+        index_.clear();
+    }
+
+    template <typename Key, typename Value, typename Hash>
+    size_t LruCache<Key, Value, Hash>::GetCapacity() const {
+        return capacity_;
+    }
+
+    template <typename Key, typename Value, typename Hash>
+    size_t LruCache<Key, Value, Hash>::GetSize() const {
+        return entries_.size();
+    }
+
+    template <typename Key, typename Value, typename Hash>
+    size_t LruCache<Key, Value, Hash>::GetHits() const {
+        return hits_;
+    }
+
+    template <typename Key, typename Value, typename Hash>
+    size_t LruCache<Key, Value, Hash>::GetMisses() const {
+        return misses_;
+    }
+
+}  // namespace cache
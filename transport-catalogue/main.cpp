@@ -1,4 +1,5 @@
-﻿#include <iostream>
+﻿#include <algorithm>
+#include <iostream>
 #include <fstream>
 #include <ostream>
 #include <string>
@@ -51,10 +52,18 @@ int main(int argc, char** argv) {
 		//hendler.DisplayResult(input_json2.GetRequestsToCatalogue(), out);
 
 
-		ofstream out_db(input_json.GetSerializationSettings().AsMap().at("file"s).AsString(), ios::binary);
+		const json::Dict& serialization_settings = input_json.GetSerializationSettings().AsMap();
+		ofstream out_db(serialization_settings.at("file"s).AsString(), ios::binary);
+
+		// граф и таблица маршрутов в отдельном файле, который process_requests отображает в память
+		const bool separate_routing_table = serialization_settings.count("routing_table_file"s) > 0;
+		if (separate_routing_table) {
+			ofstream out_table(serialization_settings.at("routing_table_file"s).AsString(), ios::binary);
+			SerializeRoutingTable(router, out_table);
+		}
 
 		if (out_db.is_open()) {
-			Serialize(tc, map, router, out_db);
+			Serialize(tc, map, router, out_db, !separate_routing_table);
 		}
 	}
 	else if (program_mode == "process_requests"sv) {
@@ -79,10 +88,16 @@ int main(int argc, char** argv) {
 		TransportRouter router;
 
 		JesonReader input_json(json::Load(in));
-		std::ifstream db_file(input_json.GetSerializationSettings().AsMap().at("file"s).AsString(), std::ios::binary);
+		const json::Dict& serialization_settings = input_json.GetSerializationSettings().AsMap();
+		std::ifstream db_file(serialization_settings.at("file"s).AsString(), std::ios::binary);
+
+		std::string routing_table_file;
+		if (serialization_settings.count("routing_table_file"s)) {
+			routing_table_file = serialization_settings.at("routing_table_file"s).AsString();
+		}
 
 		if (db_file.is_open()) {
-			DeSerialize(tc, map, router, db_file);
+			DeSerialize(tc, map, router, db_file, routing_table_file);
 		}
 
 		//for (const auto& v : router.GetGraph().edges_) {
@@ -94,11 +109,33 @@ int main(int argc, char** argv) {
 		//	}
 		//}
 
-		RequestHandler hendler(tc, map, router);
+		size_t route_cache_size = RequestHandler::DEFAULT_ROUTE_CACHE_SIZE;
+		bool print_stats = false;
+		const json::Node& cache_settings = input_json.GetCacheSettings();
+		if (cache_settings.IsDict() && cache_settings.AsMap().count("route_cache_size"s)) {
+			// отрицательный размер, как и 0, отключает кэш
+			route_cache_size = static_cast<size_t>(std::max(0, cache_settings.AsMap().at("route_cache_size"s).AsInt()));
+		}
+		// статистика кэшей в std::cerr только по запросу
+		if (cache_settings.IsDict() && cache_settings.AsMap().count("print_stats"s)) {
+			print_stats = cache_settings.AsMap().at("print_stats"s).AsBool();
+		}
+
+		RequestHandler hendler(tc, map, router, route_cache_size);
 
 		ofstream out; 
 		out.open("hello.txt");
 		hendler.DisplayResult(input_json.GetRequestsToCatalogue(), out);
+
+		if (print_stats) {
+			const RouteCache& route_cache = hendler.GetRouteCache();
+			cerr << "route cache: hits "sv << route_cache.GetHits() << ", misses "sv << route_cache.GetMisses()
+				<< ", size "sv << route_cache.GetSize() << '/' << route_cache.GetCapacity() << endl;
+			if (const auto& lazy_router = router.GetLazyRouter()) {
+				cerr << "route table rows: hits "sv << lazy_router->GetHits() << ", misses "sv << lazy_router->GetMisses()
+					<< ", size "sv << lazy_router->GetRowCount() << '/' << lazy_router->GetRowBudget() << endl;
+			}
+		}
 	}
 	else {
 		cerr << "incorrect argument!" << endl;
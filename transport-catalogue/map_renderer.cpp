@@ -11,46 +11,23 @@ bool IsZero(double value)
 	return std::abs(value) < EPSILON;
 }
 
-void MapRenderer::Render(std::ostream& out, std::vector<domain::Bus*> buses)
+void MapRenderer::Render(std::ostream& out, const std::vector<domain::Bus*>& buses, const std::vector<domain::Stop*>& stops)
 { 
-	std::map<std::string_view, std::pair<geo::Coordinates, geo::Coordinates>> start_end_of_route;//       
-	for (const auto route : buses) {
-
-		auto start_end_stop = std::make_pair(route->stop_on_route[0]->coordinates, 
-			route->stop_on_route[route->stop_on_route.size() - 1]->coordinates);
-
-		if (!route->is_roundtrip) {
-			start_end_stop.second = route->stop_on_route[route->stop_on_route.size() / 2]->coordinates;
-		}
-
-		start_end_of_route[route->name] = start_end_stop;
-	}
-
 	std::vector<geo::Coordinates> geo_coords;//        
-	std::map<std::string_view, std::vector<domain::Stop*>> map_geo_coords;//   
-	std::map<std::string_view, geo::Coordinates> uniq_stops;//  
-	for (const auto route : buses) {
-		if (!route->stop_on_route.size()) {
-			continue;
-		}
-		geo_coords.reserve(geo_coords.size() + route->stop_on_route.size());
-		std::for_each(route->stop_on_route.begin(), route->stop_on_route.end(),
-			[&](const auto& stop) {
-				geo_coords.emplace_back(stop->coordinates);
-				uniq_stops[stop->name] = stop->coordinates;
-			});
-		map_geo_coords[route->name] = route->stop_on_route;
+	geo_coords.reserve(stops.size());
+	for (const auto stop : stops) {
+		geo_coords.emplace_back(stop->coordinates);
 	}
 
 	proj_ = std::move(SphereProjector{ geo_coords.begin(), geo_coords.end(), properties_.width_, properties_.height_, properties_.padding_ });
 
-	AddRouteLine(map_geo_coords);
+	AddRouteLine(buses);
 
-	AddRouteName(start_end_of_route);
+	AddRouteName(buses);
 
-	AddStop(uniq_stops);
+	AddStop(stops);
 
-	AddStopName(uniq_stops);
+	AddStopName(stops);
 	
 	map_.Render(out);
 }
@@ -65,12 +42,15 @@ const RenderProperties& MapRenderer::GetRenderProperties() const
 	return properties_;
 }
 
-void MapRenderer::AddRouteLine(std::map<std::string_view, std::vector<domain::Stop*>>& map_geo_coords)
+void MapRenderer::AddRouteLine(const std::vector<domain::Bus*>& buses)
 {
 	size_t color_num = 0;
-	for (const auto& [_, stop] : map_geo_coords) {
+	for (const auto bus : buses) {
+		if (bus->stop_on_route.empty()) {
+			continue;
+		}
 		svg::Polyline route;
-		for (const auto coords : stop) {
+		for (const auto coords : bus->stop_on_route) {
 			route.AddPoint(proj_(coords->coordinates));
 		}
 		route.SetFillColor(svg::NoneColor);
@@ -88,7 +68,7 @@ void MapRenderer::AddRouteLine(std::map<std::string_view, std::vector<domain::St
 	}
 }
 
-void MapRenderer::AddRouteName(std::map<std::string_view, std::pair<geo::Coordinates, geo::Coordinates>>& start_end_of_route)
+void MapRenderer::AddRouteName(const std::vector<domain::Bus*>& buses)
 {
 	size_t color_num = 0;
 
@@ -114,18 +94,26 @@ void MapRenderer::AddRouteName(std::map<std::string_view, std::pair<geo::Coordin
 		substrate.SetStrokeLineJoin(svg::StrokeLineJoin::ROUND);
 	};
 
-	for (const auto& [name, coords] : start_end_of_route) {
+	for (const auto bus : buses) {
+		if (bus->stop_on_route.empty()) {
+			continue;
+		}
+
+		//       ,     -   
+		const auto& route = bus->stop_on_route;
+		const geo::Coordinates first = route.front()->coordinates;
+		const geo::Coordinates last = bus->is_roundtrip ? route.back()->coordinates : route[route.size() / 2]->coordinates;
 
 		svg::Text text;
 		svg::Text substrate;
 
-		set_text(text, substrate, proj_(coords.first), name);
+		set_text(text, substrate, proj_(first), bus->name);
 
 		map_.Add(substrate);
 		map_.Add(text);
 
-		if (coords.first != coords.second) {
-			set_text(text, substrate, proj_(coords.second), name);
+		if (first != last) {
+			set_text(text, substrate, proj_(last), bus->name);
 
 			map_.Add(substrate);
 			map_.Add(text);
@@ -138,13 +126,13 @@ void MapRenderer::AddRouteName(std::map<std::string_view, std::pair<geo::Coordin
 	}
 }
 
-void MapRenderer::AddStop(std::map<std::string_view, geo::Coordinates>& stop)
+void MapRenderer::AddStop(const std::vector<domain::Stop*>& stops)
 {
-	for (const auto& [_, coord] : stop) {
+	for (const auto stop : stops) {
 
 		svg::Circle stop_on_map;
 
-		stop_on_map.SetCenter(proj_(coord));
+		stop_on_map.SetCenter(proj_(stop->coordinates));
 		stop_on_map.SetRadius(properties_.stop_radius_);
 		stop_on_map.SetFillColor(std::string("white"));
 
@@ -153,9 +141,11 @@ void MapRenderer::AddStop(std::map<std::string_view, geo::Coordinates>& stop)
 	}
 }
 
-void MapRenderer::AddStopName(std::map<std::string_view, geo::Coordinates>& stop)
+void MapRenderer::AddStopName(const std::vector<domain::Stop*>& stops)
 {
-	for (const auto& [name, coord] : stop) {
+	for (const auto stop : stops) {
+		const geo::Coordinates coord = stop->coordinates;
+		const std::string_view name = stop->name;
 
 		svg::Text stop_name;
 		svg::Text substrate;
@@ -114,16 +114,17 @@ class MapRenderer
 public:
     MapRenderer() = default;
 
-    void Render(std::ostream& out, std::vector<domain::Bus*> route);
+    //       , . TransportCatalogue::GetSortedAllBuses
+    void Render(std::ostream& out, const std::vector<domain::Bus*>& buses, const std::vector<domain::Stop*>& stops);
 
     RenderProperties& GetRenderProperties();
     const RenderProperties& GetRenderProperties() const;
 
 private:
-    void AddRouteLine(std::map<std::string_view, std::vector<domain::Stop*>>& map_geo_coords);
-    void AddRouteName(std::map<std::string_view, std::pair<geo::Coordinates, geo::Coordinates>>& start_end_of_route);
-    void AddStop(std::map<std::string_view, geo::Coordinates>& stop);
-    void AddStopName(std::map<std::string_view, geo::Coordinates>& stop);
+    void AddRouteLine(const std::vector<domain::Bus*>& buses);
+    void AddRouteName(const std::vector<domain::Bus*>& buses);
+    void AddStop(const std::vector<domain::Stop*>& stops);
+    void AddStopName(const std::vector<domain::Stop*>& stops);
 
     RenderProperties properties_ {};
     SphereProjector proj_{};
@@ -0,0 +1,81 @@
+#include "mapped_file.h"
+
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <fstream>
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std::literals;
+
+namespace tc_project {
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string& path)
+{
+	std::ifstream in(path, std::ios::binary);
+	if (!in) {
+		throw std::runtime_error("Can't open "s + path);
+	}
+	buffer_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+	data_ = buffer_.data();
+	size_ = buffer_.size();
+}
+
+MappedFile::~MappedFile() = default;
+
+#else
+
+MappedFile::MappedFile(const std::string& path)
+{
+	const int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		throw std::runtime_error("Can't open "s + path);
+	}
+
+	struct stat file_stat {};
+	if (fstat(fd, &file_stat) != 0) {
+		close(fd);
+		throw std::runtime_error("Can't stat "s + path);
+	}
+	size_ = static_cast<size_t>(file_stat.st_size);
+
+	if (size_ > 0) {
+		void* data = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+		if (data == MAP_FAILED) {
+			close(fd);
+			throw std::runtime_error("Can't map "s + path);
+		}
+		data_ = static_cast<const char*>(data);
+	}
+	// отображение остаётся действительным и после закрытия дескриптора
+	close(fd);
+}
+
+MappedFile::~MappedFile()
+{
+	if (data_) {
+		munmap(const_cast<char*>(data_), size_);
+	}
+}
+
+#endif
+
+const char* MappedFile::GetData() const
+{
+	return data_;
+}
+
+size_t MappedFile::GetSize() const
+{
+	return size_;
+}
+
+}//namespace tc_project
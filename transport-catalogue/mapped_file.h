@@ -0,0 +1,30 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace tc_project {
+
+// Файл, отображённый в память только для чтения. Страницы разделяются
+// между процессами, отобразившими один и тот же файл.
+class MappedFile
+{
+public:
+	explicit MappedFile(const std::string& path);
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	const char* GetData() const;
+	size_t GetSize() const;
+
+private:
+	const char* data_ = nullptr;
+	size_t size_ = 0;
+#ifdef _WIN32
+	std::vector<char> buffer_{};// без mmap файл читается целиком
+#endif
+};
+
+}//namespace tc_project
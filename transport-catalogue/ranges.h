@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <iterator>
 #include <string_view>
 #include <unordered_map>
@@ -28,6 +29,44 @@ namespace ranges {
         It end_;
     };
 
+    // итератор по последовательным числам, чтобы отдавать отрезок номеров без массива
+    template <typename Integer>
+    class CountingIterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Integer;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Integer*;
+        using reference = Integer;
+
+        CountingIterator() = default;
+        explicit CountingIterator(Integer value)
+            : value_(value) {
+        }
+
+        Integer operator*() const {
+            return value_;
+        }
+        CountingIterator& operator++() {
+            ++value_;
+            return *this;
+        }
+        CountingIterator operator++(int) {
+            CountingIterator result = *this;
+            ++value_;
+            return result;
+        }
+        bool operator==(const CountingIterator& other) const {
+            return value_ == other.value_;
+        }
+        bool operator!=(const CountingIterator& other) const {
+            return value_ != other.value_;
+        }
+
+    private:
+        Integer value_{};
+    };
+
     template <typename C>
     auto AsRange(const C& container) {
         return Range{ container.begin(), container.end() };
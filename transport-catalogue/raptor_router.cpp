@@ -0,0 +1,172 @@
+#include "raptor_router.h"
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+namespace tc_project {
+
+namespace transport_router {
+
+RaptorRouter::RaptorRouter(size_t stop_count, double bus_wait_time, std::vector<Trip> trips)
+	: stop_count_(stop_count)
+	, bus_wait_time_(bus_wait_time)
+	, trips_(std::move(trips))
+{
+	BuildIndex();
+}
+
+void RaptorRouter::AddTrips(std::vector<Trip> trips) {
+	std::move(trips.begin(), trips.end(), std::back_inserter(trips_));
+	BuildIndex();
+}
+
+void RaptorRouter::RemoveBus(uint32_t bus_id) {
+	trips_.erase(std::remove_if(trips_.begin(), trips_.end(), [bus_id](const Trip& trip) {
+		return trip.bus_id == bus_id;
+		}), trips_.end());
+	BuildIndex();
+}
+
+void RaptorRouter::BuildIndex() {
+	trip_bus_ids_.clear();
+	trip_offsets_.assign(1, 0);
+	trip_stops_.clear();
+	trip_ride_times_.clear();
+	stop_offsets_.assign(stop_count_ + 1, 0);
+
+	for (const Trip& trip : trips_) {
+		if (trip.stops.empty() || trip.ride_times.size() + 1 != trip.stops.size()) {
+			throw std::invalid_argument("Trip needs a ride time between every two stops");
+		}
+		trip_bus_ids_.push_back(trip.bus_id);
+		for (size_t i = 0; i < trip.stops.size(); ++i) {
+			if (trip.stops[i] >= stop_count_) {
+				throw std::out_of_range("Stop id is out of range");
+			}
+			trip_stops_.push_back(static_cast<uint32_t>(trip.stops[i]));
+			trip_ride_times_.push_back(i == 0 ? 0.0 : trip.ride_times[i - 1]);
+			++stop_offsets_[trip.stops[i] + 1];
+		}
+		trip_offsets_.push_back(static_cast<uint32_t>(trip_stops_.size()));
+	}
+
+	for (size_t stop = 0; stop < stop_count_; ++stop) {
+		stop_offsets_[stop + 1] += stop_offsets_[stop];
+	}
+	stop_trips_.resize(trip_stops_.size());
+	std::vector<uint32_t> next(stop_offsets_.begin(), stop_offsets_.end() - 1);
+	for (uint32_t trip = 0; trip + 1 < trip_offsets_.size(); ++trip) {
+		for (uint32_t index = trip_offsets_[trip]; index < trip_offsets_[trip + 1]; ++index) {
+			stop_trips_[next[trip_stops_[index]]++] = { trip, index };
+		}
+	}
+}
+
+std::vector<std::vector<RaptorRouter::Label>> RaptorRouter::Search(size_t from, size_t to) const {
+	const double infinity = std::numeric_limits<double>::infinity();
+	std::vector<std::vector<Label>> rounds(1, std::vector<Label>(stop_count_));
+	std::vector<double> best_times(stop_count_, infinity);
+	rounds[0][from].time = 0.0;
+	best_times[from] = 0.0;
+
+	std::vector<size_t> marked_stops{ from };
+	std::vector<bool> is_marked(stop_count_, false);
+	std::vector<uint32_t> first_index(trip_bus_ids_.size(), NO_TRIP);// откуда просматривать рейс в этом раунде
+	std::vector<uint32_t> trips_to_scan;
+
+	for (uint32_t round = 1; !marked_stops.empty(); ++round) {
+		for (const size_t stop : marked_stops) {
+			for (uint32_t i = stop_offsets_[stop]; i < stop_offsets_[stop + 1]; ++i) {
+				const TripStop& trip_stop = stop_trips_[i];
+				if (first_index[trip_stop.trip] == NO_TRIP) {
+					trips_to_scan.push_back(trip_stop.trip);
+				}
+				first_index[trip_stop.trip] = std::min(first_index[trip_stop.trip], trip_stop.index);
+			}
+			is_marked[stop] = false;
+		}
+		marked_stops.clear();
+
+		rounds.push_back(rounds.back());
+		const std::vector<Label>& prev_labels = rounds[round - 1];
+		std::vector<Label>& labels = rounds[round];
+
+		for (const uint32_t trip : trips_to_scan) {
+			double time = infinity;// время в рейсе с лучшей посадкой до текущей остановки
+			uint32_t board_index = 0;
+			for (uint32_t index = first_index[trip]; index < trip_offsets_[trip + 1]; ++index) {
+				const uint32_t stop = trip_stops_[index];
+				time += trip_ride_times_[index];
+				const double target_time = to < stop_count_ ? best_times[to] : infinity;
+				if (time < best_times[stop] && time < target_time) {
+					labels[stop] = { time, trip, board_index, index, round };
+					best_times[stop] = time;
+					if (!is_marked[stop]) {
+						is_marked[stop] = true;
+						marked_stops.push_back(stop);
+					}
+				}
+				// на этой остановке можно сесть раньше, чем ехать от предыдущей посадки
+				if (prev_labels[stop].time + bus_wait_time_ < time) {
+					time = prev_labels[stop].time + bus_wait_time_;
+					board_index = index;
+				}
+			}
+			first_index[trip] = NO_TRIP;
+		}
+		trips_to_scan.clear();
+	}
+	return rounds;
+}
+
+std::optional<RaptorRouter::Journey> RaptorRouter::BuildRoute(size_t from, size_t to) const {
+	if (from >= stop_count_ || to >= stop_count_) {
+		throw std::out_of_range("Stop id is out of range");
+	}
+
+	const auto rounds = Search(from, to);
+	Label label = rounds.back()[to];
+	if (label.time == std::numeric_limits<double>::infinity()) {
+		return std::nullopt;
+	}
+
+	std::vector<Leg> legs;
+	while (label.trip != NO_TRIP) {
+		// время участка складывается так же, как вес ребра в TransportRouter::BuildGraph
+		double total_time = bus_wait_time_;
+		for (uint32_t index = label.board_index + 1; index <= label.alight_index; ++index) {
+			total_time += trip_ride_times_[index];
+		}
+		const uint32_t board_stop = trip_stops_[label.board_index];
+		legs.push_back({ trip_bus_ids_[label.trip], board_stop, static_cast<int>(label.alight_index - label.board_index), total_time });
+		label = rounds[label.round - 1][board_stop];
+	}
+	std::reverse(legs.begin(), legs.end());
+
+	Journey journey;
+	for (const Leg& leg : legs) {
+		journey.total_time += leg.total_time;
+	}
+	journey.legs = std::move(legs);
+	return journey;
+}
+
+std::vector<std::optional<double>> RaptorRouter::BuildRouteTimes(size_t from) const {
+	if (from >= stop_count_) {
+		throw std::out_of_range("Stop id is out of range");
+	}
+
+	const auto rounds = Search(from, stop_count_);
+	std::vector<std::optional<double>> times(stop_count_);
+	for (size_t stop = 0; stop < stop_count_; ++stop) {
+		if (rounds.back()[stop].time != std::numeric_limits<double>::infinity()) {
+			times[stop] = rounds.back()[stop].time;
+		}
+	}
+	return times;
+}
+
+}//namespace transport_router
+
+}//namespace tc_project
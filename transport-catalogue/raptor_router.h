@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
+namespace tc_project {
+
+namespace transport_router {
+
+// Поиск по раундам (RAPTOR): раунд k находит лучшее время с k посадками, просматривая
+// рейсы, проходящие через остановки, улучшенные в раунде k - 1. Рейсы и остановки
+// хранятся плоскими массивами, поэтому раунд - последовательный проход по памяти.
+// Время ожидания одинаково для всех посадок, расписания нет.
+class RaptorRouter {
+public:
+	// один рейс автобуса: остановки по порядку, ride_times[i] - время от stops[i] до stops[i + 1]
+	struct Trip {
+		uint32_t bus_id;// номер автобуса, как в RouteWeight
+		std::vector<size_t> stops;
+		std::vector<double> ride_times;
+	};
+
+	// посадка на остановке from_stop и поездка через span_count перегонов;
+	// total_time - ожидание плюс поездка, сложенные так же, как вес ребра графа
+	struct Leg {
+		uint32_t bus_id = 0;
+		uint32_t from_stop = 0;
+		int span_count = 0;
+		double total_time = 0.0;
+	};
+
+	struct Journey {
+		double total_time = 0.0;
+		std::vector<Leg> legs;
+	};
+
+	RaptorRouter(size_t stop_count, double bus_wait_time, std::vector<Trip> trips);
+
+	std::optional<Journey> BuildRoute(size_t from, size_t to) const;
+	// время от from до каждой остановки, nullopt - маршрута нет
+	std::vector<std::optional<double>> BuildRouteTimes(size_t from) const;
+
+	void AddTrips(std::vector<Trip> trips);
+	void RemoveBus(uint32_t bus_id);
+
+private:
+	static constexpr uint32_t NO_TRIP = std::numeric_limits<uint32_t>::max();
+
+	// метка остановки в раунде: время и рейс, на котором до неё доехали
+	struct Label {
+		double time = std::numeric_limits<double>::infinity();
+		uint32_t trip = NO_TRIP;
+		uint32_t board_index = 0;// индексы в trip_stops_
+		uint32_t alight_index = 0;
+		uint32_t round = 0;// раунд, в котором метка установлена
+	};
+
+	struct TripStop {
+		uint32_t trip;
+		uint32_t index;
+	};
+
+	// метки всех раундов; с to != stop_count_ поиск отсекает всё, что не быстрее лучшего времени до to
+	std::vector<std::vector<Label>> Search(size_t from, size_t to) const;
+
+	void BuildIndex();
+
+	size_t stop_count_ = 0;
+	double bus_wait_time_ = 0.0;
+	std::vector<Trip> trips_;
+
+	std::vector<uint32_t> trip_bus_ids_;
+	std::vector<uint32_t> trip_offsets_;// остановки рейса t - [trip_offsets_[t], trip_offsets_[t + 1])
+	std::vector<uint32_t> trip_stops_;
+	std::vector<double> trip_ride_times_;// время от предыдущей остановки рейса, 0 для первой
+
+	std::vector<uint32_t> stop_offsets_;// рейсы через остановку s - [stop_offsets_[s], stop_offsets_[s + 1])
+	std::vector<TripStop> stop_trips_;
+};
+
+}//namespace transport_router
+
+}//namespace tc_project
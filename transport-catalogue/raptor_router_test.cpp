@@ -0,0 +1,106 @@
+#include "test_base.h"
+
+#include <cmath>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Проверка режима RAPTOR: время поездки между любыми остановками должно совпасть с поиском Дейкстры
+// по графу, а участки поездки - быть настоящими: автобус идёт от остановки посадки через span_count
+// перегонов к остановке посадки следующего участка, время в пути равно расстоянию по дорогам
+
+using namespace tc_project;
+using namespace tc_project::test;
+using namespace std::literals;
+
+namespace {
+
+constexpr size_t STOP_COUNT = 40;
+constexpr size_t BUS_COUNT = 14;
+
+const std::vector<std::string> GRAPH_MODELS = { "complete"s, "linear"s };
+
+// время поездки в минутах по остановкам stops[first, first + span_count]
+double ComputeRideTime(const transport_catalogue::TransportCatalogue& catalogue, const transport_router::RouterSettings& settings,
+	const std::vector<domain::Stop*>& stops, size_t first, int span_count) {
+	double distance = 0.0;
+	for (size_t i = first; i < first + span_count; ++i) {
+		distance += catalogue.GetStopsDistance({ stops[i], stops[i + 1] });
+	}
+	return distance / (settings.bus_velocity_ * transport_router::KM_TO_MIN_FACTOR);
+}
+
+// остановка, где заканчивается участок, или nullopt, если автобус так не ездит
+std::optional<std::string> FindLegEnd(const transport_catalogue::TransportCatalogue& catalogue, const transport_router::TransportRouter& router,
+	const transport_router::RouteLeg& leg) {
+	const domain::Bus* bus = catalogue.FindBus(router.GetBusNameFromID(leg.bus_id));
+	if (!bus || leg.span_count <= 0) {
+		return std::nullopt;
+	}
+	const auto& stops = bus->stop_on_route;
+	const std::string_view board_stop = router.GetStopNameFromID(leg.stop_id);
+	for (size_t first = 0; first + leg.span_count < stops.size(); ++first) {
+		if (stops[first]->name == board_stop
+			&& IsSameTime(ComputeRideTime(catalogue, router.GetRouterSettings(), stops, first, leg.span_count), leg.ride_time)) {
+			return stops[first + leg.span_count]->name;
+		}
+	}
+	return std::nullopt;
+}
+
+}//namespace
+
+int main() {
+	const TestBase base = MakeTestBase(STOP_COUNT, BUS_COUNT, 14);
+
+	transport_catalogue::TransportCatalogue expected_catalogue;
+	transport_router::TransportRouter expected_router;
+	Fill(expected_catalogue, expected_router, base.MakeDocument(MakeRoutingSettings("dijkstra"s)));
+
+	size_t failures = 0;
+	for (const std::string& graph_model : GRAPH_MODELS) {
+		transport_catalogue::TransportCatalogue catalogue;
+		transport_router::TransportRouter router;
+		Fill(catalogue, router, base.MakeDocument(MakeRoutingSettings("raptor"s, graph_model)));
+		const double bus_wait_time = router.GetRouterSettings().bus_wait_time_;
+
+		size_t time_mismatches = 0;
+		size_t broken_journeys = 0;
+		size_t journeys_with_transfers = 0;
+		for (size_t from = 0; from < STOP_COUNT; ++from) {
+			for (size_t to = 0; to < STOP_COUNT; ++to) {
+				const auto journey = router.BuildJourney(StopName(from), StopName(to));
+				const auto expected = expected_router.BuildJourney(StopName(from), StopName(to));
+				if (journey.has_value() != expected.has_value()) {
+					++time_mismatches;
+					continue;
+				}
+				if (!journey) {
+					continue;
+				}
+				time_mismatches += !IsSameTime(journey->total_time, expected->total_time);
+				journeys_with_transfers += journey->legs.size() > 1;
+
+				// участки идут один за другим от from до to, а их время в сумме - время поездки
+				std::string stop = StopName(from);
+				double total_time = 0.0;
+				bool is_broken = false;
+				for (const auto& leg : journey->legs) {
+					const auto leg_end = FindLegEnd(catalogue, router, leg);
+					if (router.GetStopNameFromID(leg.stop_id) != stop || !leg_end) {
+						is_broken = true;
+						break;
+					}
+					stop = *leg_end;
+					total_time += bus_wait_time + leg.ride_time;
+				}
+				broken_journeys += is_broken || stop != StopName(to) || !IsSameTime(total_time, journey->total_time);
+			}
+		}
+		failures += !Check(time_mismatches == 0, graph_model + ": "s + std::to_string(time_mismatches) + " journey time(s) differ from Dijkstra"s);
+		failures += !Check(broken_journeys == 0, graph_model + ": "s + std::to_string(broken_journeys) + " journey(s) with impossible legs"s);
+		failures += !Check(journeys_with_transfers > 0, graph_model + ": "s + "the base has no journeys with transfers"s);
+	}
+
+	return Finish(failures);
+}
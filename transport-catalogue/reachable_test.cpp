@@ -0,0 +1,110 @@
+#include "test_base.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+// Проверка TransportRouter::BuildReachableStops: остановки, найденные поиском с границей по времени,
+// должны совпасть с перебором маршрутов всех пар до каждой остановки и идти по возрастанию времени, затем имени
+
+using namespace tc_project;
+using namespace tc_project::test;
+using namespace std::literals;
+
+namespace {
+
+constexpr size_t STOP_COUNT = 40;
+constexpr size_t BUS_COUNT = 14;
+
+const std::vector<std::string> ROUTING_MODES = {
+	"all_pairs"s, "dijkstra"s, "contraction_hierarchy"s, "a_star"s, "raptor"s, "lazy_all_pairs"s, "alt"s, "bidirectional_dijkstra"s,
+};
+
+const std::vector<std::string> GRAPH_MODELS = { "complete"s, "linear"s };
+
+const std::vector<double> MAX_TIMES = { 0.0, 7.5, 20.0, 45.0, 1e9 };
+
+// перебор: остановки, время Route до которых не больше max_time
+std::vector<std::pair<std::string, double>> FindReachableByScan(const transport_router::TransportRouter& router, size_t from, double max_time) {
+	std::vector<std::pair<std::string, double>> stops;
+	for (size_t to = 0; to < STOP_COUNT; ++to) {
+		const auto route = router.BuildRouter(StopName(from), StopName(to));
+		if (route && route->weight.total_time <= max_time) {
+			stops.emplace_back(StopName(to), route->weight.total_time);
+		}
+	}
+	return stops;
+}
+
+// время на границе сравнивается с допуском: остановку у самой границы можно не проверять
+bool IsNearBound(double time, double max_time) {
+	return std::abs(time - max_time) <= 1e-9 * std::max(1.0, max_time);
+}
+
+}//namespace
+
+int main() {
+	const TestBase base = MakeTestBase(STOP_COUNT, BUS_COUNT, 12);
+
+	transport_catalogue::TransportCatalogue expected_catalogue;
+	transport_router::TransportRouter expected_router;
+	Fill(expected_catalogue, expected_router, base.MakeDocument(MakeRoutingSettings("all_pairs"s)));
+
+	size_t failures = 0;
+	for (const std::string& graph_model : GRAPH_MODELS) {
+		for (const std::string& routing_mode : ROUTING_MODES) {
+			transport_catalogue::TransportCatalogue catalogue;
+			transport_router::TransportRouter router;
+			Fill(catalogue, router, base.MakeDocument(MakeRoutingSettings(routing_mode, graph_model)));
+
+			size_t mismatches = 0;
+			size_t unordered = 0;
+			for (size_t from = 0; from < STOP_COUNT; ++from) {
+				for (const double max_time : MAX_TIMES) {
+					const auto found = router.BuildReachableStops(StopName(from), max_time);
+					auto expected = FindReachableByScan(expected_router, from, max_time);
+
+					for (size_t i = 1; i < found.size(); ++i) {
+						unordered += std::tie(found[i].second, found[i].first) < std::tie(found[i - 1].second, found[i - 1].first);
+					}
+
+					std::vector<std::pair<std::string, double>> found_sorted;
+					for (const auto& [stop_name, time] : found) {
+						mismatches += time > max_time;
+						if (!IsNearBound(time, max_time)) {
+							found_sorted.emplace_back(std::string(stop_name), time);
+						}
+					}
+					expected.erase(std::remove_if(expected.begin(), expected.end(), [max_time](const auto& stop) {
+						return IsNearBound(stop.second, max_time);
+						}), expected.end());
+					// наборы сравниваются по именам, порядок проверен выше
+					std::sort(found_sorted.begin(), found_sorted.end());
+					std::sort(expected.begin(), expected.end());
+
+					if (found_sorted.size() != expected.size()) {
+						++mismatches;
+						continue;
+					}
+					for (size_t i = 0; i < expected.size(); ++i) {
+						mismatches += found_sorted[i].first != expected[i].first || !IsSameTime(found_sorted[i].second, expected[i].second);
+					}
+				}
+			}
+			const std::string context = routing_mode + ", "s + graph_model + ": "s;
+			failures += !Check(mismatches == 0, context + std::to_string(mismatches) + " reachable set(s) differ from the scan"s);
+			failures += !Check(unordered == 0, context + std::to_string(unordered) + " pair(s) out of time and name order"s);
+		}
+	}
+
+	// остановка без автобусов достижима только сама из себя
+	const auto isolated = expected_router.BuildReachableStops(StopName(STOP_COUNT - 1), 1e9);
+	failures += !Check(isolated.size() == 1 && isolated[0].first == StopName(STOP_COUNT - 1) && isolated[0].second == 0.0,
+		"stop without buses reaches something but itself"s);
+
+	return Finish(failures);
+}
@@ -6,51 +6,162 @@ using namespace std::literals;
 
 namespace tc_project {
 
-RequestHandler::RequestHandler(transport_catalogue::TransportCatalogue& tc, render::MapRenderer& map, transport_router::TransportRouter& router)
+RequestHandler::RequestHandler(transport_catalogue::TransportCatalogue& tc, render::MapRenderer& map, transport_router::TransportRouter& router,
+	size_t route_cache_size)
 	: catalogue_(tc)
 	, map_(map)
 	, router_(router)
+	, route_cache_(route_cache_size)
 {}
 
 void RequestHandler::DisplayResult(const json::Node& document, std::ostream& output)
 {
 	const json::Array& request = document.AsArray();
 
-	json::Array output_array;
-	output_array.reserve(request.size());
+	// ответы печатаются по одному в том же формате, что и json::Print для массива,
+	// чтобы RouteMatrix мог писать матрицу прямо в поток
+	output << "[\n"sv;
 
 	bool map_is_processed = false;
+	bool first = true;
 	for (const auto& dict : request) {
 
 		const json::Dict& request_data = dict.AsMap();
 
+		if (!first) {
+			output << ",\n"sv;
+		}
+		first = false;
+
 		if (!map_is_processed && request_data.at("type"s).AsString() == "Map"sv) {
 			std::ostringstream xml_map;
-			map_.Render(xml_map, GetAllBuses());
-			output_array.emplace_back(FindMapInfo(xml_map.str(), request_data.at("id"s).AsInt()));
+			map_.Render(xml_map, GetAllBuses(), GetStopsOnRoutes());
+			json::Print(json::Document{ FindMapInfo(xml_map.str(), request_data.at("id"s).AsInt()) }, output);
 			map_is_processed = true;
 		}
 		else if(request_data.at("type"s).AsString() == "Route"sv) {
-			output_array.emplace_back(FindRoureInfo(router_, request_data.at("from"s).AsString(), request_data.at("to"s).AsString(), request_data.at("id"s).AsInt()));
+			json::Print(json::Document{ FindRoute(request_data.at("from"s).AsString(), request_data.at("to"s).AsString(), request_data.at("id"s).AsInt()) }, output);
+		}
+		else if (request_data.at("type"s).AsString() == "RouteMatrix"sv) {
+			PrintRouteMatrix(request_data.at("from"s).AsArray(), request_data.at("to"s).AsArray(), request_data.at("id"s).AsInt(), output);
+		}
+		else if (request_data.at("type"s).AsString() == "Reachable"sv) {
+			json::Print(json::Document{ FindReachableInfo(router_, catalogue_, request_data.at("from"s).AsString(),
+				request_data.at("max_time"s).AsDouble(), request_data.at("id"s).AsInt()) }, output);
+		}
+		else if (request_data.at("type"s).AsString() == "NearestStops"sv) {
+			const geo::Coordinates point(request_data.at("latitude"s).AsDouble(), request_data.at("longitude"s).AsDouble());
+			const int count = request_data.at("count"s).AsInt();
+			json::Print(json::Document{ FindStopsByDistanceInfo(catalogue_.GetNearestStops(point, count > 0 ? count : 0),
+				request_data.at("id"s).AsInt()) }, output);
+		}
+		else if (request_data.at("type"s).AsString() == "StopsWithinRadius"sv) {
+			const geo::Coordinates point(request_data.at("latitude"s).AsDouble(), request_data.at("longitude"s).AsDouble());
+			json::Print(json::Document{ FindStopsByDistanceInfo(catalogue_.GetStopsWithinRadius(point, request_data.at("radius"s).AsDouble()),
+				request_data.at("id"s).AsInt()) }, output);
 		}
 		else if(request_data.at("type"s).AsString() == "Stop"sv) {
-			output_array.emplace_back(FindStopInfo(catalogue_, request_data.at("name"s).AsString(), request_data.at("id"s).AsInt()));
+			json::Print(json::Document{ FindStopInfo(catalogue_, request_data.at("name"s).AsString(), request_data.at("id"s).AsInt()) }, output);
 		}
 		else {
-			output_array.emplace_back(FindBusInfo(catalogue_, request_data.at("name"s).AsString(), request_data.at("id"s).AsInt()));
+			json::Print(json::Document{ FindBusInfo(catalogue_, request_data.at("name"s).AsString(), request_data.at("id"s).AsInt()) }, output);
 		}
 	}
 
-	json::Print(json::Document{json::Builder{}.Value(std::move(output_array)).Build()}, output);
+	output << "\n]"sv;
 }
 
-std::vector<domain::Bus*> RequestHandler::GetAllBuses()
+void RequestHandler::PrintRouteMatrix(const json::Array& from, const json::Array& to, int id, std::ostream& output)
 {
-	const auto& sort_buses = catalogue_.GetSortedAllBuses();
-	if (sort_buses) {
-		return sort_buses.value();
+	std::vector<std::string_view> stops_from;
+	std::vector<std::string_view> stops_to;
+	stops_from.reserve(from.size());
+	stops_to.reserve(to.size());
+	for (const auto& stop : from) {
+		stops_from.push_back(stop.AsString());
+	}
+	for (const auto& stop : to) {
+		stops_to.push_back(stop.AsString());
 	}
-	return {};
+
+	const auto is_unknown = [this](std::string_view stop) { return catalogue_.FindStop(stop) == nullptr; };
+	if (std::any_of(stops_from.begin(), stops_from.end(), is_unknown) || std::any_of(stops_to.begin(), stops_to.end(), is_unknown)) {
+		json::Print(json::Document{ json::Builder{}.StartDict().Key("request_id"s).Value(id)
+			.Key("error_message"s).Value("not found"s).EndDict().Build() }, output);
+		return;
+	}
+
+	// строка матрицы - время от одной остановки from до всех to, null - маршрута нет
+	output << "{\n\"request_id\": "sv << id << ",\n\"total_times\": [\n"sv;
+	bool first_row = true;
+	for (const std::string_view stop_from : stops_from) {
+		if (!first_row) {
+			output << ",\n"sv;
+		}
+		first_row = false;
+
+		output << "[\n"sv;
+		bool first_cell = true;
+		for (const auto& time : router_.BuildRouteTimes(stop_from, stops_to)) {
+			if (!first_cell) {
+				output << ",\n"sv;
+			}
+			first_cell = false;
+
+			if (time) {
+				output << *time;
+			}
+			else {
+				output << "null"sv;
+			}
+		}
+		output << "\n]"sv;
+	}
+	output << "\n]\n}"sv;
+}
+
+const RouteCache& RequestHandler::GetRouteCache() const
+{
+	return route_cache_;
+}
+
+json::Node RequestHandler::FindRoute(std::string_view from, std::string_view to, int id)
+{
+	const domain::Stop* stop_from = catalogue_.FindStop(from);
+	const domain::Stop* stop_to = catalogue_.FindStop(to);
+	if (route_cache_.GetCapacity() == 0 || !stop_from || !stop_to) {
+		return FindRoureInfo(router_, from, to, id);
+	}
+
+	// ключ ссылается на имена в каталоге, они живут дольше обработчика
+	const std::pair<std::string_view, std::string_view> key{ stop_from->name, stop_to->name };
+	if (const json::Dict* cached = route_cache_.Find(key)) {
+		json::Dict result = *cached;
+		result["request_id"s] = id;
+		return result;
+	}
+
+	json::Node result = FindRoureInfo(router_, from, to, id);
+	json::Dict to_cache = result.AsMap();
+	to_cache.erase("request_id"s);
+	route_cache_.Insert(key, std::move(to_cache));
+	return result;
+}
+
+const std::vector<domain::Bus*>& RequestHandler::GetAllBuses()
+{
+	return catalogue_.GetSortedAllBuses();
+}
+
+std::vector<domain::Stop*> RequestHandler::GetStopsOnRoutes()
+{
+	std::vector<domain::Stop*> stops;
+	for (domain::Stop* stop : catalogue_.GetSortedAllStops()) {
+		if (!catalogue_.GetBusesOnStop(stop->id).empty()) {
+			stops.push_back(stop);
+		}
+	}
+	return stops;
 }
 
 
@@ -128,28 +239,55 @@ json::Node FindMapInfo(std::string_view render_obj, int id)
 json::Node FindRoureInfo(transport_router::TransportRouter& router, std::string_view from, std::string_view to, int id)
 {
 	json::Builder result;
-	auto tc_router = router.BuildRouter(from, to);
+	auto tc_router = router.BuildJourney(from, to);
 	if (!tc_router) {
 		return json::Builder{}.StartDict().Key("request_id"s).Value(id)
 			.Key("error_message"s).Value("not found"s).EndDict().Build();
 	}
 	else {
-		const auto& graph = router.GetGraph();
+		const auto wait_time = router.GetRouterSettings().bus_wait_time_;
 		result.StartDict().Key("items"s).StartArray();
-		for (const auto& edge : tc_router->edges) {
-			const auto& edge_info = graph.GetEdge(edge);
-			auto wait_time = router.GetRouterSettings().bus_wait_time_;
-			result.StartDict().Key("stop_name"s).Value(std::string(router.GetStopNameFromID(edge_info.from)))
+		for (const auto& leg : tc_router->legs) {
+			result.StartDict().Key("stop_name"s).Value(std::string(router.GetStopNameFromID(leg.stop_id)))
 				.Key("time"s).Value(wait_time)
 				.Key("type"s).Value("Wait"s).EndDict()
-				.StartDict().Key("bus"s).Value(std::string(edge_info.weight.bus_name))
-				.Key("span_count"s).Value(edge_info.weight.span_count)
-				.Key("time"s).Value(edge_info.weight.total_time - wait_time)
+				.StartDict().Key("bus"s).Value(std::string(router.GetBusNameFromID(leg.bus_id)))
+				.Key("span_count"s).Value(leg.span_count)
+				.Key("time"s).Value(leg.ride_time)
 				.Key("type"s).Value("Bus"s).EndDict();
 		}
 		result.EndArray().Key("request_id"s).Value(id)
-			.Key("total_time"s).Value(tc_router->weight.total_time).EndDict();
+			.Key("total_time"s).Value(tc_router->total_time).EndDict();
+	}
+	return result.Build();
+}
+
+json::Node FindReachableInfo(transport_router::TransportRouter& router, transport_catalogue::TransportCatalogue& tc, std::string_view from, double max_time, int id)
+{
+	if (!tc.FindStop(from)) {
+		return json::Builder{}.StartDict().Key("request_id"s).Value(id)
+			.Key("error_message"s).Value("not found"s).EndDict().Build();
+	}
+
+	json::Builder result;
+	result.StartDict().Key("request_id"s).Value(id).Key("stops"s).StartArray();
+	for (const auto& [stop_name, time] : router.BuildReachableStops(from, max_time)) {
+		result.StartDict().Key("stop_name"s).Value(std::string(stop_name))
+			.Key("time"s).Value(time).EndDict();
+	}
+	result.EndArray().EndDict();
+	return result.Build();
+}
+
+json::Node FindStopsByDistanceInfo(const std::vector<std::pair<const domain::Stop*, double>>& stops, int id)
+{
+	json::Builder result;
+	result.StartDict().Key("request_id"s).Value(id).Key("stops"s).StartArray();
+	for (const auto& [stop, distance] : stops) {
+		result.StartDict().Key("stop_name"s).Value(stop->name)
+			.Key("distance"s).Value(distance).EndDict();
 	}
+	result.EndArray().EndDict();
 	return result.Build();
 }
 
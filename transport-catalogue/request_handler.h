@@ -3,30 +3,59 @@
 #include "transport_router.h"
 #include "map_renderer.h"
 #include "json.h"
+#include "lru_cache.h"
 
 namespace tc_project {
 
+namespace detail {
+
+struct RouteCacheKeyHasher {
+	size_t operator() (const std::pair<std::string_view, std::string_view>& stops) const {
+		return str_v_hasher(stops.first) + str_v_hasher(stops.second) * 37;
+	}
+
+	std::hash<std::string_view> str_v_hasher;
+};
+
+}//namespace detail
+
+// ответы на запросы Route без request_id, ключ - имена остановок из каталога
+using RouteCache = cache::LruCache<std::pair<std::string_view, std::string_view>, json::Dict, detail::RouteCacheKeyHasher>;
+
 class RequestHandler
 {
 public:
+	static constexpr size_t DEFAULT_ROUTE_CACHE_SIZE = 1024;
 	
-	RequestHandler(transport_catalogue::TransportCatalogue& tc, render::MapRenderer& map, transport_router::TransportRouter& router);
+	RequestHandler(transport_catalogue::TransportCatalogue& tc, render::MapRenderer& map, transport_router::TransportRouter& router,
+		size_t route_cache_size = DEFAULT_ROUTE_CACHE_SIZE);
 
 	void DisplayResult(const json::Node& document, std::ostream& output);
 
+	const RouteCache& GetRouteCache() const;
+
 private:
 
-	std::vector<domain::Bus*> GetAllBuses();
+	const std::vector<domain::Bus*>& GetAllBuses();
+	// остановки, через которые проходит хотя бы один автобус, по возрастанию имени
+	std::vector<domain::Stop*> GetStopsOnRoutes();
+	json::Node FindRoute(std::string_view from, std::string_view to, int id);
+	// матрица времени в пути печатается сразу в поток, без json::Node на ячейку
+	void PrintRouteMatrix(const json::Array& from, const json::Array& to, int id, std::ostream& output);
 
 	transport_catalogue::TransportCatalogue& catalogue_;
 	render::MapRenderer& map_;
 	transport_router::TransportRouter& router_;
+	RouteCache route_cache_;
 };
 
 json::Node FindStopInfo(transport_catalogue::TransportCatalogue& tc, std::string_view stop_name, int id);
 json::Node FindBusInfo(transport_catalogue::TransportCatalogue& tc, std::string_view bus_name, int id);
 json::Node FindMapInfo(std::string_view render_obj, int id);
 json::Node FindRoureInfo(transport_router::TransportRouter& router, std::string_view from, std::string_view to, int id);
+json::Node FindReachableInfo(transport_router::TransportRouter& router, transport_catalogue::TransportCatalogue& tc, std::string_view from, double max_time, int id);
+// ответ на NearestStops и StopsWithinRadius: остановки и расстояния до них в метрах
+json::Node FindStopsByDistanceInfo(const std::vector<std::pair<const domain::Stop*, double>>& stops, int id);
 
 
 }//namespace tc_project
\ No newline at end of file
@@ -0,0 +1,123 @@
+#include "json.h"
+#include "map_renderer.h"
+#include "request_handler.h"
+#include "test_base.h"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Проверка запроса RouteMatrix: ответ, напечатанный прямо в поток, разбирается как JSON, и каждая ячейка
+// сравнивается с маршрутом Route маршрутизатора всех пар. null - только там, где маршрута нет
+
+using namespace tc_project;
+using namespace tc_project::test;
+using namespace std::literals;
+
+namespace {
+
+constexpr size_t STOP_COUNT = 40;
+constexpr size_t BUS_COUNT = 14;
+
+const std::vector<std::string> ROUTING_MODES = {
+	"all_pairs"s, "dijkstra"s, "contraction_hierarchy"s, "a_star"s, "raptor"s, "lazy_all_pairs"s, "alt"s, "bidirectional_dijkstra"s,
+};
+
+const std::vector<std::string> GRAPH_MODELS = { "complete"s, "linear"s };
+
+json::Array MakeStopNames(const std::vector<size_t>& stops) {
+	json::Array names;
+	for (const size_t stop : stops) {
+		names.push_back(StopName(stop));
+	}
+	return names;
+}
+
+}//namespace
+
+int main() {
+	const TestBase base = MakeTestBase(STOP_COUNT, BUS_COUNT, 11);
+
+	// строки - все остановки, столбцы - в обратном порядке и с повтором; последняя остановка без автобусов
+	std::vector<size_t> from(STOP_COUNT);
+	for (size_t stop = 0; stop < STOP_COUNT; ++stop) {
+		from[stop] = stop;
+	}
+	std::vector<size_t> to(from.rbegin(), from.rend());
+	to.push_back(0);
+
+	json::Array stat_requests{
+		json::Dict{ { "id"s, 1 }, { "type"s, "RouteMatrix"s }, { "from"s, MakeStopNames(from) }, { "to"s, MakeStopNames(to) } },
+		json::Dict{ { "id"s, 2 }, { "type"s, "RouteMatrix"s }, { "from"s, MakeStopNames({ 0 }) }, { "to"s, json::Array{ "Unknown stop"s } } },
+		json::Dict{ { "id"s, 3 }, { "type"s, "RouteMatrix"s }, { "from"s, json::Array{} }, { "to"s, MakeStopNames({ 0 }) } },
+	};
+
+	transport_catalogue::TransportCatalogue expected_catalogue;
+	transport_router::TransportRouter expected_router;
+	Fill(expected_catalogue, expected_router, base.MakeDocument(MakeRoutingSettings("all_pairs"s)));
+
+	size_t failures = 0;
+	for (const std::string& graph_model : GRAPH_MODELS) {
+		for (const std::string& routing_mode : ROUTING_MODES) {
+			const std::string context = routing_mode + ", "s + graph_model + ": "s;
+			const json::Document document = base.MakeDocument(MakeRoutingSettings(routing_mode, graph_model), stat_requests);
+
+			transport_catalogue::TransportCatalogue catalogue;
+			transport_router::TransportRouter router;
+			Fill(catalogue, router, document);
+			render::MapRenderer map;
+			RequestHandler handler(catalogue, map, router);
+
+			std::stringstream output;
+			handler.DisplayResult(document.GetRoot().AsMap().at("stat_requests"s), output);
+			const json::Array answers = json::Load(output).GetRoot().AsArray();
+			if (!Check(answers.size() == stat_requests.size(), context + "wrong number of answers"s)) {
+				++failures;
+				continue;
+			}
+
+			const json::Dict& matrix = answers[0].AsMap();
+			failures += !Check(matrix.at("request_id"s).AsInt() == 1, context + "wrong request_id"s);
+			const json::Array& rows = matrix.at("total_times"s).AsArray();
+			if (!Check(rows.size() == from.size(), context + "wrong number of rows"s)) {
+				++failures;
+				continue;
+			}
+			size_t mismatches = 0;
+			size_t null_cells = 0;
+			for (size_t row = 0; row < from.size(); ++row) {
+				const json::Array& cells = rows[row].AsArray();
+				if (cells.size() != to.size()) {
+					++mismatches;
+					continue;
+				}
+				for (size_t column = 0; column < to.size(); ++column) {
+					const auto route = expected_router.BuildRouter(StopName(from[row]), StopName(to[column]));
+					if (!route) {
+						++null_cells;
+						mismatches += !cells[column].IsNull();
+					}
+					// время печатается с точностью потока по умолчанию, 6 значащих цифр
+					else if (cells[column].IsNull()
+						|| std::abs(cells[column].AsDouble() - route->weight.total_time) > 1e-5 * std::max(1.0, route->weight.total_time)) {
+						++mismatches;
+					}
+				}
+			}
+			failures += !Check(mismatches == 0, context + std::to_string(mismatches) + " cell(s) differ from Route"s);
+			failures += !Check(null_cells > 0, context + "the base has no unreachable pairs to check null cells"s);
+
+			const json::Dict& unknown = answers[1].AsMap();
+			failures += !Check(unknown.at("request_id"s).AsInt() == 2 && unknown.count("error_message"s)
+				&& unknown.at("error_message"s).AsString() == "not found"s, context + "unknown stop isn't reported as not found"s);
+
+			const json::Dict& empty = answers[2].AsMap();
+			failures += !Check(empty.at("request_id"s).AsInt() == 3 && empty.at("total_times"s).AsArray().empty(),
+				context + "matrix without rows isn't empty"s);
+		}
+	}
+
+	return Finish(failures);
+}
@@ -4,31 +4,93 @@
 
 #include <algorithm>
 #include <cassert>
+#include <condition_variable>
 #include <cstdint>
 #include <iterator>
+#include <limits>
+#include <mutex>
 #include <optional>
+#include <queue>
 #include <stdexcept>
+#include <thread>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
 namespace graph {
 
+    namespace detail {
+
+        // Точка синхронизации потоков: Wait() возвращается, когда до неё дошли все участники
+        class Barrier {
+        public:
+            explicit Barrier(size_t participants)
+                : participants_(participants) {
+            }
+
+            void Wait() {
+                std::unique_lock lock(mutex_);
+                const size_t generation = generation_;
+                if (++arrived_ == participants_) {
+                    arrived_ = 0;
+                    ++generation_;
+                    condition_.notify_all();
+                    return;
+                }
+                condition_.wait(lock, [this, generation] { return generation != generation_; });
+            }
+
+        private:
+            std::mutex mutex_;
+            std::condition_variable condition_;
+            const size_t participants_;
+            size_t arrived_ = 0;
+            size_t generation_ = 0;
+        };
+
+    }  // namespace detail
+
+    // Скалярное представление веса для компактной таблицы маршрутов Router.
+    // Для составных весов специализируется рядом с их определением.
+    template <typename Weight>
+    struct WeightTraits {
+        using Scalar = Weight;
+
+        static Scalar ToScalar(const Weight& weight) {
+            return weight;
+        }
+
+        static Weight FromScalar(Scalar scalar) {
+            return scalar;
+        }
+    };
+
     template <typename Weight>
     class Router {
     private:
         using Graph = DirectedWeightedGraph<Weight>;
+        using Traits = WeightTraits<Weight>;
 
     public:
+        using Scalar = typename Traits::Scalar;
+        using EdgeIndex = uint32_t;
 
-        struct RouteInternalData {
-            Weight weight;
-            std::optional<EdgeId> prev_edge;
-        };
+        static_assert(std::numeric_limits<Scalar>::has_infinity, "Router needs a scalar weight with infinity");
 
-        using RoutesInternalData = std::vector<std::vector<std::optional<RouteInternalData>>>;
+        // в строке from: NO_EDGE - путь из from в себя, UNREACHABLE - пути нет
+        static constexpr EdgeIndex NO_EDGE = std::numeric_limits<EdgeIndex>::max();
+        static constexpr EdgeIndex UNREACHABLE = NO_EDGE - 1;
 
-        explicit Router(const Graph& graph, bool initialize = true);
+        // Плотная таблица V x V по строкам: вес кратчайшего пути from -> to
+        // (бесконечность, если пути нет) и последнее ребро этого пути
+        struct RoutesInternalData {
+            std::vector<Scalar> weights;
+            std::vector<EdgeIndex> prev_edges;
+        };
+
+        explicit Router(const Graph& graph, bool initialize = true, size_t thread_count = 1);
+        // таблица во внешней памяти (например, отображённом файле), которая должна жить дольше Router
+        Router(const Graph& graph, const Scalar* weights, const EdgeIndex* prev_edges);
 
         struct RouteInfo {
             Weight weight;
@@ -36,6 +98,22 @@ namespace graph {
         };
 
         std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const;
+        // только вес из таблицы, без восстановления пути
+        std::optional<Weight> GetRouteWeight(VertexId from, VertexId to) const;
+
+        // Граф изменён на месте без изменения числа вершин: new_edge_ids[old_id] - новый номер ребра
+        // или Graph::REMOVED_EDGE, added_edges - новые номера добавленных рёбер.
+        // Строки, в которых путь шёл через удалённое ребро, пересчитываются поиском Дейкстры,
+        // добавленные рёбра учитываются релаксацией через их концы: O(K * V^2) для K концов
+        void UpdateRoutes(const std::vector<EdgeId>& new_edge_ids, const std::vector<EdgeId>& added_edges);
+
+        // строка таблицы для from поиском Дейкстры: weights и prev_edges - по GetVertexCount() ячеек
+        // в формате RoutesInternalData. Нужна и тем, кто хранит строки по отдельности, см. LazyRouter
+        static void ComputeRouteRow(const Graph& graph, VertexId vertex_from, Scalar* weights, EdgeIndex* prev_edges);
+
+        // проверка таблицы из базы или файла перед BuildRoute: в строке from ячейка from - NO_EDGE,
+        // ребро в ячейке to ведёт в to, а цепочка предыдущих рёбер доходит до from без циклов. O(V^2)
+        static bool CheckPrevEdges(const Graph& graph, const EdgeIndex* prev_edges);
 
         RoutesInternalData& GetRoutesInternalData() {
             return routes_internal_data_;
@@ -48,82 +126,311 @@ namespace graph {
     private:
         void InitializeRoutesInternalData(const Graph& graph) {
             const size_t vertex_count = graph.GetVertexCount();
+            auto& weights = routes_internal_data_.weights;
+            auto& prev_edges = routes_internal_data_.prev_edges;
+            const auto& edges = graph.GetEdges();
             for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
-                routes_internal_data_[vertex][vertex] = RouteInternalData{ FIRST_WEIGHT, std::nullopt };
+                const size_t row = vertex * vertex_count;
+                weights[row + vertex] = Traits::ToScalar(FIRST_WEIGHT);
+                prev_edges[row + vertex] = NO_EDGE;
                 for (const EdgeId edge_id : graph.GetIncidentEdges(vertex)) {
-                    const auto& edge = graph.GetEdge(edge_id);
+                    const auto& edge = edges[edge_id];
                     if (edge.weight < FIRST_WEIGHT) {
                         throw std::domain_error("Edges' weights should be non-negative");
                     }
-                    auto& route_internal_data = routes_internal_data_[vertex][edge.to];
-                    if (!route_internal_data || route_internal_data->weight > edge.weight) {
-                        route_internal_data = RouteInternalData{ edge.weight, edge_id };
+                    const Scalar edge_weight = Traits::ToScalar(edge.weight);
+                    if (edge_weight < weights[row + edge.to]) {
+                        weights[row + edge.to] = edge_weight;
+                        prev_edges[row + edge.to] = static_cast<EdgeIndex>(edge_id);
                     }
                 }
             }
         }
 
-        void RelaxRoute(VertexId vertex_from, VertexId vertex_to, const RouteInternalData& route_from,
-            const RouteInternalData& route_to) {
-            auto& route_relaxing = routes_internal_data_[vertex_from][vertex_to];
-            const Weight candidate_weight = route_from.weight + route_to.weight;
-            if (!route_relaxing || candidate_weight < route_relaxing->weight) {
-                route_relaxing = { candidate_weight,
-                                  route_to.prev_edge ? route_to.prev_edge : route_from.prev_edge };
+        // Недостижимые ячейки хранят бесконечность, поэтому сравнение кандидата
+        // не требует отдельных проверок и внутренний цикл остаётся без ветвлений по ячейкам
+        void RelaxRoutesInternalDataThroughVertex(size_t vertex_count, VertexId vertex_through,
+            VertexId vertex_from_begin, VertexId vertex_from_end) {
+            Scalar* const weights = routes_internal_data_.weights.data();
+            EdgeIndex* const prev_edges = routes_internal_data_.prev_edges.data();
+            const Scalar* const weights_through = weights + vertex_through * vertex_count;
+            const EdgeIndex* const prev_edges_through = prev_edges + vertex_through * vertex_count;
+
+            for (VertexId vertex_from = vertex_from_begin; vertex_from < vertex_from_end; ++vertex_from) {
+                Scalar* const weights_from = weights + vertex_from * vertex_count;
+                EdgeIndex* const prev_edges_from = prev_edges + vertex_from * vertex_count;
+                if (prev_edges_from[vertex_through] == UNREACHABLE) {
+                    continue;
+                }
+                const Scalar weight_from = weights_from[vertex_through];
+                const EdgeIndex prev_edge_from = prev_edges_from[vertex_through];
+                for (VertexId vertex_to = 0; vertex_to < vertex_count; ++vertex_to) {
+                    const Scalar candidate_weight = weight_from + weights_through[vertex_to];
+                    if (candidate_weight < weights_from[vertex_to]) {
+                        weights_from[vertex_to] = candidate_weight;
+                        prev_edges_from[vertex_to] = prev_edges_through[vertex_to] != NO_EDGE
+                            ? prev_edges_through[vertex_to] : prev_edge_from;
+                    }
+                }
             }
         }
 
-        void RelaxRoutesInternalDataThroughVertex(size_t vertex_count, VertexId vertex_through) {
-            for (VertexId vertex_from = 0; vertex_from < vertex_count; ++vertex_from) {
-                if (const auto& route_from = routes_internal_data_[vertex_from][vertex_through]) {
-                    for (VertexId vertex_to = 0; vertex_to < vertex_count; ++vertex_to) {
-                        if (const auto& route_to = routes_internal_data_[vertex_through][vertex_to]) {
-                            RelaxRoute(vertex_from, vertex_to, *route_from, *route_to);
-                        }
-                    }
+        // строка from заново, поиском Дейкстры по текущему графу
+        void ComputeRoutesInternalDataRow(VertexId vertex_from) {
+            const size_t vertex_count = graph_.GetVertexCount();
+            ComputeRouteRow(graph_, vertex_from, routes_internal_data_.weights.data() + vertex_from * vertex_count,
+                routes_internal_data_.prev_edges.data() + vertex_from * vertex_count);
+        }
+
+        // Строки vertex_from на шаге vertex_through независимы: строка и столбец vertex_through
+        // на этом шаге не меняются. Поэтому строки делятся между потоками, а шаги разделяются
+        // барьером - результат совпадает с последовательным построением бит в бит.
+        void RelaxRoutesInternalDataParallel(size_t vertex_count, size_t thread_count) {
+            detail::Barrier barrier(thread_count);
+            const size_t rows_per_thread = (vertex_count + thread_count - 1) / thread_count;
+
+            auto relax_rows = [this, vertex_count, &barrier](VertexId vertex_from_begin, VertexId vertex_from_end) {
+                for (VertexId vertex_through = 0; vertex_through < vertex_count; ++vertex_through) {
+                    RelaxRoutesInternalDataThroughVertex(vertex_count, vertex_through, vertex_from_begin, vertex_from_end);
+                    barrier.Wait();
                 }
+            };
+
+            std::vector<std::thread> workers;
+            workers.reserve(thread_count - 1);
+            for (size_t thread = 1; thread < thread_count; ++thread) {
+                const VertexId vertex_from_begin = std::min(vertex_count, thread * rows_per_thread);
+                const VertexId vertex_from_end = std::min(vertex_count, vertex_from_begin + rows_per_thread);
+                workers.emplace_back(relax_rows, vertex_from_begin, vertex_from_end);
+            }
+            relax_rows(0, std::min(vertex_count, rows_per_thread));
+
+            for (auto& worker : workers) {
+                worker.join();
             }
         }
 
         static constexpr Weight FIRST_WEIGHT{};
         const Graph& graph_;
         RoutesInternalData routes_internal_data_;
+        const Scalar* external_weights_ = nullptr;
+        const EdgeIndex* external_prev_edges_ = nullptr;
     };
 
     template <typename Weight>
-    Router<Weight>::Router(const Graph& graph, bool initialize)
+    Router<Weight>::Router(const Graph& graph, bool initialize, size_t thread_count)
         : graph_(graph)
-        , routes_internal_data_(graph.GetVertexCount(),
-            std::vector<std::optional<RouteInternalData>>(graph.GetVertexCount()))
     {
+        if (graph.GetEdgeCount() >= UNREACHABLE) {
+            throw std::length_error("Too many edges for the route table");
+        }
+
+        const size_t cell_count = graph.GetVertexCount() * graph.GetVertexCount();
+        routes_internal_data_.weights.assign(cell_count, std::numeric_limits<Scalar>::infinity());
+        routes_internal_data_.prev_edges.assign(cell_count, UNREACHABLE);
+
         if (initialize) {
             InitializeRoutesInternalData(graph);
 
             const size_t vertex_count = graph.GetVertexCount();
+            thread_count = std::min(thread_count, vertex_count);
+            if (thread_count > 1) {
+                RelaxRoutesInternalDataParallel(vertex_count, thread_count);
+                return;
+            }
             for (VertexId vertex_through = 0; vertex_through < vertex_count; ++vertex_through) {
-                RelaxRoutesInternalDataThroughVertex(vertex_count, vertex_through);
+                RelaxRoutesInternalDataThroughVertex(vertex_count, vertex_through, 0, vertex_count);
+            }
+        }
+    }
+
+    template <typename Weight>
+    Router<Weight>::Router(const Graph& graph, const Scalar* weights, const EdgeIndex* prev_edges)
+        : graph_(graph)
+        , external_weights_(weights)
+        , external_prev_edges_(prev_edges)
+    {
+    }
+
+    template <typename Weight>
+    void Router<Weight>::UpdateRoutes(const std::vector<EdgeId>& new_edge_ids, const std::vector<EdgeId>& added_edges) {
+        const size_t vertex_count = graph_.GetVertexCount();
+        const size_t cell_count = vertex_count * vertex_count;
+        if (graph_.GetEdgeCount() >= UNREACHABLE) {
+            throw std::length_error("Too many edges for the route table");
+        }
+        // внешняя таблица только для чтения, изменения делаются в собственной копии
+        if (external_weights_) {
+            routes_internal_data_.weights.assign(external_weights_, external_weights_ + cell_count);
+            routes_internal_data_.prev_edges.assign(external_prev_edges_, external_prev_edges_ + cell_count);
+            external_weights_ = nullptr;
+            external_prev_edges_ = nullptr;
+        }
+        if (routes_internal_data_.weights.size() != cell_count) {
+            throw std::logic_error("Vertex count of the graph has changed");
+        }
+
+        std::vector<VertexId> stale_rows;
+        for (VertexId vertex_from = 0; vertex_from < vertex_count; ++vertex_from) {
+            EdgeIndex* const prev_edges = routes_internal_data_.prev_edges.data() + vertex_from * vertex_count;
+            bool stale = false;
+            for (VertexId vertex_to = 0; vertex_to < vertex_count; ++vertex_to) {
+                const EdgeIndex edge_id = prev_edges[vertex_to];
+                if (edge_id == NO_EDGE || edge_id == UNREACHABLE) {
+                    continue;
+                }
+                const EdgeId new_edge_id = new_edge_ids.at(edge_id);
+                if (new_edge_id == Graph::REMOVED_EDGE) {
+                    stale = true;
+                }
+                else {
+                    prev_edges[vertex_to] = static_cast<EdgeIndex>(new_edge_id);
+                }
+            }
+            if (stale) {
+                stale_rows.push_back(vertex_from);
             }
         }
+        for (const VertexId vertex_from : stale_rows) {
+            ComputeRoutesInternalDataRow(vertex_from);
+        }
+
+        // новые пути состоят из старых кратчайших путей и новых рёбер, поэтому
+        // алгоритма Флойда по концам новых рёбер достаточно
+        std::vector<bool> is_end(vertex_count, false);
+        std::vector<VertexId> ends;
+        for (const EdgeId edge_id : added_edges) {
+            const auto& edge = graph_.GetEdge(edge_id);
+            if (edge.weight < FIRST_WEIGHT) {
+                throw std::domain_error("Edges' weights should be non-negative");
+            }
+            const size_t cell = edge.from * vertex_count + edge.to;
+            const Scalar edge_weight = Traits::ToScalar(edge.weight);
+            if (edge_weight < routes_internal_data_.weights[cell]) {
+                routes_internal_data_.weights[cell] = edge_weight;
+                routes_internal_data_.prev_edges[cell] = static_cast<EdgeIndex>(edge_id);
+            }
+            for (const VertexId vertex : { edge.from, edge.to }) {
+                if (!is_end[vertex]) {
+                    is_end[vertex] = true;
+                    ends.push_back(vertex);
+                }
+            }
+        }
+        for (const VertexId vertex_through : ends) {
+            RelaxRoutesInternalDataThroughVertex(vertex_count, vertex_through, 0, vertex_count);
+        }
+    }
+
+    template <typename Weight>
+    void Router<Weight>::ComputeRouteRow(const Graph& graph, VertexId vertex_from, Scalar* weights, EdgeIndex* prev_edges) {
+        const size_t vertex_count = graph.GetVertexCount();
+        std::fill(weights, weights + vertex_count, std::numeric_limits<Scalar>::infinity());
+        std::fill(prev_edges, prev_edges + vertex_count, UNREACHABLE);
+        weights[vertex_from] = Traits::ToScalar(FIRST_WEIGHT);
+        prev_edges[vertex_from] = NO_EDGE;
+
+        using QueueItem = std::pair<Scalar, VertexId>;
+        std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>> queue;
+        queue.push({ weights[vertex_from], vertex_from });
+        const auto& edges = graph.GetEdges();
+        while (!queue.empty()) {
+            const auto [weight, vertex] = queue.top();
+            queue.pop();
+            if (weights[vertex] < weight) {
+                continue;
+            }
+            for (const EdgeId edge_id : graph.GetIncidentEdges(vertex)) {
+                const auto& edge = edges[edge_id];
+                const Scalar candidate_weight = weight + Traits::ToScalar(edge.weight);
+                if (candidate_weight < weights[edge.to]) {
+                    weights[edge.to] = candidate_weight;
+                    prev_edges[edge.to] = static_cast<EdgeIndex>(edge_id);
+                    queue.push({ candidate_weight, edge.to });
+                }
+            }
+        }
+    }
+
+    template <typename Weight>
+    bool Router<Weight>::CheckPrevEdges(const Graph& graph, const EdgeIndex* prev_edges) {
+        const size_t vertex_count = graph.GetVertexCount();
+        const size_t edge_count = graph.GetEdgeCount();
+        // состояние вершины в строке: 0 - не проверена, 1 - на текущей цепочке, 2 - цепочка доходит до from
+        std::vector<uint8_t> states(vertex_count);
+        std::vector<VertexId> chain;
+        for (VertexId vertex_from = 0; vertex_from < vertex_count; ++vertex_from) {
+            const EdgeIndex* const row = prev_edges + vertex_from * vertex_count;
+            if (row[vertex_from] != NO_EDGE) {
+                return false;
+            }
+            std::fill(states.begin(), states.end(), 0);
+            states[vertex_from] = 2;
+            for (VertexId vertex_to = 0; vertex_to < vertex_count; ++vertex_to) {
+                if (row[vertex_to] == UNREACHABLE) {
+                    continue;
+                }
+                chain.clear();
+                VertexId vertex = vertex_to;
+                while (states[vertex] == 0) {
+                    const EdgeIndex edge_id = row[vertex];
+                    if (edge_id >= edge_count || graph.GetEdge(edge_id).to != vertex) {
+                        return false;
+                    }
+                    states[vertex] = 1;
+                    chain.push_back(vertex);
+                    vertex = graph.GetEdge(edge_id).from;
+                }
+                if (states[vertex] == 1) {
+                    return false;
+                }
+                for (const VertexId chain_vertex : chain) {
+                    states[chain_vertex] = 2;
+                }
+            }
+        }
+        return true;
     }
 
     template <typename Weight>
     std::optional<typename Router<Weight>::RouteInfo> Router<Weight>::BuildRoute(VertexId from,
         VertexId to) const {
-        const auto& route_internal_data = routes_internal_data_.at(from).at(to);
-        if (!route_internal_data) {
+        const size_t vertex_count = graph_.GetVertexCount();
+        if (from >= vertex_count || to >= vertex_count) {
+            throw std::out_of_range("Vertex id is out of range");
+        }
+        const size_t row = from * vertex_count;
+        const Scalar* const weights = external_weights_ ? external_weights_ : routes_internal_data_.weights.data();
+        const EdgeIndex* const prev_edges = external_prev_edges_ ? external_prev_edges_ : routes_internal_data_.prev_edges.data();
+        if (prev_edges[row + to] == UNREACHABLE) {
             return std::nullopt;
         }
-        const Weight weight = route_internal_data->weight;
+        const Weight weight = Traits::FromScalar(weights[row + to]);
         std::vector<EdgeId> edges;
-        for (std::optional<EdgeId> edge_id = route_internal_data->prev_edge;
-            edge_id;
-            edge_id = routes_internal_data_[from][graph_.GetEdge(*edge_id).from]->prev_edge)
+        for (EdgeIndex edge_id = prev_edges[row + to];
+            edge_id != NO_EDGE;
+            edge_id = prev_edges[row + graph_.GetEdge(edge_id).from])
         {
-            edges.push_back(*edge_id);
+            edges.push_back(edge_id);
         }
         std::reverse(edges.begin(), edges.end());
 
         return RouteInfo{ weight, std::move(edges) };
     }
 
+    template <typename Weight>
+    std::optional<Weight> Router<Weight>::GetRouteWeight(VertexId from, VertexId to) const {
+        const size_t vertex_count = graph_.GetVertexCount();
+        if (from >= vertex_count || to >= vertex_count) {
+            throw std::out_of_range("Vertex id is out of range");
+        }
+        const size_t cell = from * vertex_count + to;
+        const EdgeIndex* const prev_edges = external_prev_edges_ ? external_prev_edges_ : routes_internal_data_.prev_edges.data();
+        if (prev_edges[cell] == UNREACHABLE) {
+            return std::nullopt;
+        }
+        const Scalar* const weights = external_weights_ ? external_weights_ : routes_internal_data_.weights.data();
+        return Traits::FromScalar(weights[cell]);
+    }
+
 }  // namespace graph
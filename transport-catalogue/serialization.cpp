@@ -1,7 +1,10 @@
 #include "serialization.h"
+#include <algorithm>
 #include <functional>
 #include <vector>
 #include <chrono>
+#include <cstring>
+#include <iterator>
 #include <iostream>
 
 //#define LOG_DURATION(x) LogDuration time(x)
@@ -31,6 +34,82 @@
 
 namespace tc_project {
 
+namespace detail {
+
+// Файл таблицы маршрутов: заголовок, рёбра графа, имена автобусов и матрица V x V
+// (сначала веса, затем предыдущие рёбра). Секции выровнены по ROUTING_TABLE_ALIGNMENT,
+// числа записаны в порядке байтов машины, поэтому файл читается прямо из памяти.
+constexpr char ROUTING_TABLE_MAGIC[8] = { 'T', 'C', 'R', 'O', 'U', 'T', 'E', 'S' };
+constexpr uint32_t ROUTING_TABLE_VERSION = 2;
+constexpr uint64_t ROUTING_TABLE_ALIGNMENT = 64;
+
+struct RoutingTableHeader {
+	char magic[8];
+	uint32_t version;
+	uint32_t reserved;
+	uint64_t vertex_count;
+	uint64_t edge_count;
+	uint64_t bus_count;
+	uint64_t edges_offset;// RoutingTableEdge[edge_count]
+	uint64_t bus_names_offset;// uint64_t[bus_count + 1] смещений от конца массива, затем символы имён
+	uint64_t matrix_vertex_count;// 0, если матрицы нет
+	uint64_t weights_offset;// double[V * V]
+	uint64_t prev_edges_offset;// uint32_t[V * V]
+	uint64_t file_size;
+	uint64_t graph_fingerprint;// тот же, что в базе
+};
+
+struct RoutingTableEdge {
+	uint32_t from;
+	uint32_t to;
+	uint32_t bus;
+	uint32_t span_count;
+	double total_time;
+};
+
+uint64_t AlignRoutingTableOffset(uint64_t offset)
+{
+	return (offset + ROUTING_TABLE_ALIGNMENT - 1) / ROUTING_TABLE_ALIGNMENT * ROUTING_TABLE_ALIGNMENT;
+}
+
+// FNV-1a по настройкам, именам автобусов и рёбрам графа. Пишется и в базу, и в файл таблицы маршрутов:
+// файл от другого make_base с теми же остановками и автобусами по нему отличается от базы
+uint64_t ComputeGraphFingerprint(const transport_router::TransportRouter& router)
+{
+	uint64_t hash = 14695981039346656037ULL;
+	auto add = [&hash](const void* data, size_t size) {
+		const auto* bytes = static_cast<const unsigned char*>(data);
+		for (size_t i = 0; i < size; ++i) {
+			hash = (hash ^ bytes[i]) * 1099511628211ULL;
+		}
+	};
+	auto add_value = [&add](auto value) {
+		add(&value, sizeof(value));
+	};
+
+	const auto& settings = router.GetRouterSettings();
+	add_value(settings.bus_wait_time_);
+	add_value(settings.bus_velocity_);
+	add_value(static_cast<uint32_t>(settings.graph_model_));
+
+	const auto& graph = router.GetGraph();
+	add_value(static_cast<uint64_t>(graph.GetVertexCount()));
+	for (const auto name : router.GetBusNames()) {
+		add_value(static_cast<uint64_t>(name.size()));
+		add(name.data(), name.size());
+	}
+	for (const auto& edge : graph.GetEdges()) {
+		add_value(edge.from);
+		add_value(edge.to);
+		add_value(edge.weight.bus_id);
+		add_value(static_cast<uint32_t>(edge.weight.span_count));
+		add_value(edge.weight.total_time);
+	}
+	return hash;
+}
+
+}//namespace detail
+
 proto::Stop MakeStopToSerialize(const domain::Stop* stop, const transport_catalogue::TransportCatalogue& tc)
 {
 	proto::Stop stop_proto;
@@ -55,6 +134,15 @@ proto::Bus MakeBusToSerialize(const domain::Bus* bus, const transport_catalogue:
 		*bus_proto.add_stop_on_route() = MakeStopToSerialize(stop_ptr, tc);
 	}
 
+	// автобус без посчитанного BusInfo сохраняется без него, см. TransportCatalogue::ComputeBusInfo
+	if (const auto info = tc.GetComputedBusInfo(bus->id)) {
+		proto::BusInfo& info_proto = *bus_proto.mutable_info();
+		info_proto.set_stops(static_cast<uint32_t>(info->stops));
+		info_proto.set_unique_stops(static_cast<uint32_t>(info->unique_stop));
+		info_proto.set_route_length(info->route_length);
+		info_proto.set_route_curvature(info->route_curvature);
+	}
+
 	return bus_proto;
 }
 
@@ -117,74 +205,110 @@ proto::RenderProperties MakeRenderPropertiesToSerialize(const render::MapRendere
 	return render_setting_proto;
 }
 
-proto::DirectedWeightedGraph MakeGraphToSerialize(const graph::DirectedWeightedGraph<transport_router::RouteWeight>& graph, const transport_catalogue::TransportCatalogue& tc)
+proto::DirectedWeightedGraph MakeGraphToSerialize(const transport_router::TransportRouter& router)
 {
 	proto::DirectedWeightedGraph graph_proto;
-	
+	const auto& graph = router.GetGraph();
+
+	graph_proto.mutable_edges()->Reserve(static_cast<int>(graph.GetEdgeCount()));
 	for (auto& edge : graph.GetEdges()) {
 		proto::Edge proto_edge;
 		proto_edge.set_vertex_id_from(edge.from);
 		proto_edge.set_vertex_id_to(edge.to);
-		proto_edge.mutable_weight()->set_bus_name(std::string(edge.weight.bus_name));
+		proto_edge.mutable_weight()->set_bus_id(edge.weight.bus_id);
 		proto_edge.mutable_weight()->set_total_time(edge.weight.total_time);
 		proto_edge.mutable_weight()->set_span_count(edge.weight.span_count);
 		*graph_proto.add_edges() = std::move(proto_edge);
 	}
-	
-	for (auto& list : graph.GetIncidenceLists()) {
-		auto proto_list = graph_proto.add_incidence_list();
-		for (auto id : list) {
-			proto_list->add_edges_id(id);
-		}
+	for (const auto bus_name : router.GetBusNames()) {
+		graph_proto.add_bus_names(std::string(bus_name));
 	}
+	graph_proto.set_vertex_count(graph.GetVertexCount());
 
 	return graph_proto;
 }
 
-proto::Router MakeRouterToSerialize(const std::unique_ptr<graph::Router<transport_router::RouteWeight>>& router)
+proto::Router MakeRouterToSerialize(const std::unique_ptr<graph::Router<transport_router::RouteWeight>>& router, size_t vertex_count)
 {
 	proto::Router router_proto;
 
-	for (const auto& data : router->GetRoutesInternalData()) {
-		proto::RoutesInternalData p_data;
-		for (const auto& internal: data) {
-		proto::OptionalRouteInternalData p_internal;
-			if (internal.has_value()) {
-				auto& value = internal.value();
-				auto p_value = p_internal.mutable_data();
-				p_value->mutable_route_weight()->set_total_time(value.weight.total_time);
-				if (value.prev_edge.has_value()) {
-					p_value->mutable_prev_edge()->set_edge_id(value.prev_edge.value());
-				}
-			}
-		*p_data.add_routes_internal_data() = std::move(p_internal);
-		}
-		*router_proto.add_routes_data() = std::move(p_data);
-	}
+	const auto& data = router->GetRoutesInternalData();
+	router_proto.set_vertex_count(vertex_count);
+	*router_proto.mutable_weights() = { data.weights.begin(), data.weights.end() };
+	*router_proto.mutable_prev_edges() = { data.prev_edges.begin(), data.prev_edges.end() };
+
 	return router_proto;
 }
 
+proto::ContractionHierarchy MakeContractionHierarchyToSerialize(const graph::ContractionHierarchy<transport_router::RouteWeight>& ch, size_t edge_count)
+{
+	proto::ContractionHierarchy ch_proto;
+
+	ch_proto.set_edge_count(edge_count);
+	for (const auto rank : ch.GetRanks()) {
+		ch_proto.add_ranks(rank);
+	}
+	for (const auto& shortcut : ch.GetShortcuts()) {
+		auto p_shortcut = ch_proto.add_shortcuts();
+		p_shortcut->set_vertex_id_from(shortcut.from);
+		p_shortcut->set_vertex_id_to(shortcut.to);
+		p_shortcut->set_total_time(shortcut.weight.total_time);
+		p_shortcut->set_first_edge_id(shortcut.first_edge);
+		p_shortcut->set_second_edge_id(shortcut.second_edge);
+	}
+	return ch_proto;
+}
+
+proto::Landmarks MakeLandmarksToSerialize(const graph::Landmarks<transport_router::RouteWeight>& landmarks, size_t vertex_count)
+{
+	proto::Landmarks landmarks_proto;
 
+	landmarks_proto.set_vertex_count(vertex_count);
+	*landmarks_proto.mutable_vertices() = { landmarks.GetLandmarks().begin(), landmarks.GetLandmarks().end() };
+	*landmarks_proto.mutable_to_vertex() = { landmarks.GetDistancesToVertices().begin(), landmarks.GetDistancesToVertices().end() };
+	*landmarks_proto.mutable_from_vertex() = { landmarks.GetDistancesFromVertices().begin(), landmarks.GetDistancesFromVertices().end() };
+	return landmarks_proto;
+}
 
-proto::TransportRouter MakeTransportRouterToSerialize(const transport_router::TransportRouter& router, const transport_catalogue::TransportCatalogue& tc)
+proto::TransportRouter MakeTransportRouterToSerialize(const transport_router::TransportRouter& router, bool serialize_routing_table)
 {
 	proto::TransportRouter router_proto;
 
 	router_proto.mutable_settings()->set_bus_velocity(router.GetRouterSettings().bus_velocity_);
 	router_proto.mutable_settings()->set_bus_wait_time(router.GetRouterSettings().bus_wait_time_);
-	//*router_proto.mutable_graph() = std::move(MakeGraphToSerialize(router.GetGraph(), tc));
-	//*router_proto.mutable_router() = std::move(MakeRouterToSerialize(router.GetRouter()));
+	router_proto.mutable_settings()->set_routing_mode(static_cast<proto::RoutingMode>(router.GetRouterSettings().routing_mode_));
+	router_proto.mutable_settings()->set_thread_count(router.GetRouterSettings().thread_count_);
+	router_proto.mutable_settings()->set_graph_model(static_cast<proto::GraphModel>(router.GetRouterSettings().graph_model_));
+	router_proto.mutable_settings()->set_lazy_row_budget(router.GetRouterSettings().lazy_row_budget_);
+	router_proto.mutable_settings()->set_landmark_count(router.GetRouterSettings().landmark_count_);
+	router_proto.set_graph_fingerprint(detail::ComputeGraphFingerprint(router));
+	if (serialize_routing_table) {
+		*router_proto.mutable_graph() = std::move(MakeGraphToSerialize(router));
+		if (router.GetRouter()) {
+			*router_proto.mutable_router() = std::move(MakeRouterToSerialize(router.GetRouter(), router.GetGraph().GetVertexCount()));
+		}
+	}
+	if (router.GetContractionHierarchy()) {
+		*router_proto.mutable_contraction_hierarchy() = MakeContractionHierarchyToSerialize(*router.GetContractionHierarchy(), router.GetGraph().GetEdgeCount());
+	}
+	if (router.GetLandmarks()) {
+		*router_proto.mutable_landmarks() = MakeLandmarksToSerialize(*router.GetLandmarks(), router.GetGraph().GetVertexCount());
+	}
 
 	return router_proto;
 }
 
 
-void Serialize(const transport_catalogue::TransportCatalogue& tc, const render::MapRenderer& map, const transport_router::TransportRouter& router, std::ostream& out)
+void Serialize(const transport_catalogue::TransportCatalogue& tc, const render::MapRenderer& map, const transport_router::TransportRouter& router, std::ostream& out, bool serialize_routing_table)
 {
 	proto::TransportCatalogue tc_db;
 	    
-	for (const auto [name, stop_ptr] : tc.GetAlltStops()) {
-		*tc_db.add_list_of_stops() = std::move(MakeStopToSerialize(stop_ptr, tc));
+	// остановки по номерам: при загрузке они получат те же номера, на которые ссылается stop_index
+	for (uint32_t stop_id = 0; stop_id < tc.GetStopCount(); ++stop_id) {
+		*tc_db.add_list_of_stops() = std::move(MakeStopToSerialize(&tc.GetStop(stop_id), tc));
+	}
+	for (const uint32_t stop_id : tc.GetStopIndex().GetOrder()) {
+		tc_db.add_stop_index(stop_id);
 	}
 
 	for (const auto [name, bus_ptr] : tc.GetAllBuses()) {
@@ -193,11 +317,76 @@ void Serialize(const transport_catalogue::TransportCatalogue& tc, const render::
 
 	*tc_db.mutable_render_setting() = std::move(MakeRenderPropertiesToSerialize(map));
 
-	*tc_db.mutable_router() = std::move(MakeTransportRouterToSerialize(router, tc));
+	*tc_db.mutable_router() = std::move(MakeTransportRouterToSerialize(router, serialize_routing_table));
 
 	tc_db.SerializeToOstream(&out);
 }
 
+void SerializeRoutingTable(const transport_router::TransportRouter& router, std::ostream& out)
+{
+	const auto& graph = router.GetGraph();
+	const size_t vertex_count = graph.GetVertexCount();
+
+	const auto& bus_names = router.GetBusNames();
+	std::vector<detail::RoutingTableEdge> edges;
+	edges.reserve(graph.GetEdgeCount());
+	for (const auto& edge : graph.GetEdges()) {
+		edges.push_back({ edge.from, edge.to, edge.weight.bus_id,
+			static_cast<uint32_t>(edge.weight.span_count), edge.weight.total_time });
+	}
+
+	std::vector<uint64_t> name_offsets{ 0 };
+	std::string names;
+	for (const auto name : bus_names) {
+		names += name;
+		name_offsets.push_back(names.size());
+	}
+
+	const graph::Router<transport_router::RouteWeight>::RoutesInternalData* matrix = nullptr;
+	if (router.GetRouter() && router.GetRouter()->GetRoutesInternalData().weights.size() == vertex_count * vertex_count) {
+		matrix = &router.GetRouter()->GetRoutesInternalData();
+	}
+
+	detail::RoutingTableHeader header{};
+	std::copy(std::begin(detail::ROUTING_TABLE_MAGIC), std::end(detail::ROUTING_TABLE_MAGIC), header.magic);
+	header.version = detail::ROUTING_TABLE_VERSION;
+	header.vertex_count = vertex_count;
+	header.edge_count = edges.size();
+	header.bus_count = bus_names.size();
+	header.graph_fingerprint = detail::ComputeGraphFingerprint(router);
+
+	uint64_t offset = sizeof(header);
+	header.edges_offset = detail::AlignRoutingTableOffset(offset);
+	offset = header.edges_offset + edges.size() * sizeof(detail::RoutingTableEdge);
+	header.bus_names_offset = detail::AlignRoutingTableOffset(offset);
+	offset = header.bus_names_offset + name_offsets.size() * sizeof(uint64_t) + names.size();
+	if (matrix) {
+		header.matrix_vertex_count = vertex_count;
+		header.weights_offset = detail::AlignRoutingTableOffset(offset);
+		offset = header.weights_offset + matrix->weights.size() * sizeof(double);
+		header.prev_edges_offset = detail::AlignRoutingTableOffset(offset);
+		offset = header.prev_edges_offset + matrix->prev_edges.size() * sizeof(uint32_t);
+	}
+	header.file_size = offset;
+
+	uint64_t position = 0;
+	auto write_at = [&](uint64_t section_offset, const void* data, size_t size) {
+		static const char padding[detail::ROUTING_TABLE_ALIGNMENT] = {};
+		out.write(padding, section_offset - position);
+		out.write(static_cast<const char*>(data), size);
+		position = section_offset + size;
+	};
+
+	write_at(0, &header, sizeof(header));
+	write_at(header.edges_offset, edges.data(), edges.size() * sizeof(detail::RoutingTableEdge));
+	write_at(header.bus_names_offset, name_offsets.data(), name_offsets.size() * sizeof(uint64_t));
+	write_at(position, names.data(), names.size());
+	if (matrix) {
+		write_at(header.weights_offset, matrix->weights.data(), matrix->weights.size() * sizeof(double));
+		write_at(header.prev_edges_offset, matrix->prev_edges.data(), matrix->prev_edges.size() * sizeof(uint32_t));
+	}
+}
+
 
 
 
@@ -224,6 +413,38 @@ void DeSerializeTransportCatalogue(transport_catalogue::TransportCatalogue& tc,
 			tc.AddDistanceFromTo(stop.name(), stop.near_stop(i), stop.distance(i));
 		}
 	}
+
+	tc.SortIndexes();
+	// повреждённый порядок из базы не годится для поиска, индекс строится заново
+	bool has_stop_index = tc_proto.stop_index_size() > 0;
+	if (has_stop_index) {
+		try {
+			tc.SetStopIndex({ tc_proto.stop_index().begin(), tc_proto.stop_index().end() });
+		}
+		catch (const std::invalid_argument&) {
+			has_stop_index = false;
+		}
+	}
+	if (!has_stop_index) {
+		tc.BuildStopIndex();
+	}
+
+	// в базе, где BusInfo нет ни у одного автобуса, они считаются заново;
+	// автобус без BusInfo в новой базе посчитать не удалось, его запрос Bus считает сам
+	const bool has_bus_infos = std::any_of(tc_proto.list_of_buses().begin(), tc_proto.list_of_buses().end(),
+		[](const proto::Bus& bus) { return bus.has_info(); });
+	if (!has_bus_infos) {
+		tc.ComputeBusInfo();
+		return;
+	}
+	std::vector<std::optional<domain::BusInfo>> bus_infos(tc.GetBusCount());
+	for (const auto& bus : tc_proto.list_of_buses()) {
+		if (bus.has_info()) {
+			const auto& info = bus.info();
+			bus_infos[tc.FindBus(bus.name())->id] = domain::BusInfo(info.stops(), info.unique_stops(), info.route_length(), info.route_curvature());
+		}
+	}
+	tc.SetBusInfo(std::move(bus_infos));
 }
 
 void DeSerializeRenderProperties(render::RenderProperties& render_seting, const proto::RenderProperties& render_seting_proto)
@@ -264,21 +485,299 @@ void DeSerializeRenderProperties(render::RenderProperties& render_seting, const
 }
 
 
-void DeSerializeTransportRouter(transport_router::TransportRouter& router, const proto::TransportCatalogue& tc_proto, const transport_catalogue::TransportCatalogue& tc)
+bool DeSerializeContractionHierarchy(transport_router::TransportRouter& router, const proto::ContractionHierarchy& ch_proto)
+{
+	const auto& graph = router.GetGraph();
+	if (ch_proto.edge_count() != graph.GetEdgeCount() || static_cast<size_t>(ch_proto.ranks_size()) != graph.GetVertexCount()) {
+		return false;
+	}
+
+	std::vector<size_t> ranks{ ch_proto.ranks().begin(), ch_proto.ranks().end() };
+
+	std::vector<graph::ContractionHierarchy<transport_router::RouteWeight>::Shortcut> shortcuts;
+	shortcuts.reserve(ch_proto.shortcuts_size());
+	for (const auto& p_shortcut : ch_proto.shortcuts()) {
+		shortcuts.push_back({ p_shortcut.vertex_id_from(), p_shortcut.vertex_id_to(), { 0, 0, p_shortcut.total_time() },
+			p_shortcut.first_edge_id(), p_shortcut.second_edge_id() });
+	}
+
+	try {
+		router.GetContractionHierarchy() = std::make_unique<graph::ContractionHierarchy<transport_router::RouteWeight>>(graph, std::move(ranks), std::move(shortcuts));
+	}
+	catch (const std::invalid_argument&) {
+		return false;
+	}
+	return true;
+}
+
+bool DeSerializeLandmarks(transport_router::TransportRouter& router, const proto::Landmarks& landmarks_proto)
+{
+	if (landmarks_proto.vertex_count() != router.GetGraph().GetVertexCount()) {
+		return false;
+	}
+	try {
+		router.GetLandmarks() = std::make_unique<graph::Landmarks<transport_router::RouteWeight>>(router.GetGraph(),
+			std::vector<graph::VertexId>{ landmarks_proto.vertices().begin(), landmarks_proto.vertices().end() },
+			std::vector<double>{ landmarks_proto.to_vertex().begin(), landmarks_proto.to_vertex().end() },
+			std::vector<double>{ landmarks_proto.from_vertex().begin(), landmarks_proto.from_vertex().end() });
+	}
+	catch (const std::invalid_argument&) {
+		return false;
+	}
+	return true;
+}
+
+bool DeSerializeGraph(transport_router::TransportRouter& router, const proto::DirectedWeightedGraph& graph_proto, const transport_catalogue::TransportCatalogue& tc)
+{
+	std::vector<std::string_view> bus_names;
+	bus_names.reserve(graph_proto.bus_names_size());
+	for (const auto& bus_name : graph_proto.bus_names()) {
+		const domain::Bus* bus = tc.FindBus(bus_name);
+		if (!bus) {
+			return false;
+		}
+		bus_names.push_back(bus->name);
+	}
+
+	const size_t vertex_count = graph_proto.vertex_count();
+	graph::DirectedWeightedGraph<transport_router::RouteWeight> graph(vertex_count);
+	graph.GetEdges().reserve(graph_proto.edges_size());
+	for (const auto& p_edge : graph_proto.edges()) {
+		const auto& p_weight = p_edge.weight();
+		if (p_edge.vertex_id_from() >= vertex_count || p_edge.vertex_id_to() >= vertex_count || p_weight.bus_id() >= bus_names.size()) {
+			return false;
+		}
+		graph.AddEdge({ p_edge.vertex_id_from(), p_edge.vertex_id_to(),
+			{ p_weight.bus_id(), static_cast<int>(p_weight.span_count()), p_weight.total_time() } });
+	}
+	// рёбра сохранены уже упорядоченными, поэтому номера в таблице маршрутов остаются верными
+	try {
+		router.InicializeGraph(tc, std::move(graph), std::move(bus_names));
+	}
+	catch (const std::invalid_argument&) {
+		return false;
+	}
+	catch (const std::out_of_range&) {
+		return false;
+	}
+	return true;
+}
+
+bool DeSerializeRouter(transport_router::TransportRouter& router, const proto::Router& router_proto)
+{
+	const size_t vertex_count = router.GetGraph().GetVertexCount();
+	const size_t cell_count = vertex_count * vertex_count;
+	if (router_proto.vertex_count() != vertex_count
+		|| static_cast<size_t>(router_proto.weights_size()) != cell_count
+		|| static_cast<size_t>(router_proto.prev_edges_size()) != cell_count) {
+		return false;
+	}
+
+	using Router = graph::Router<transport_router::RouteWeight>;
+	std::vector<Router::EdgeIndex> prev_edges{ router_proto.prev_edges().begin(), router_proto.prev_edges().end() };
+	if (!Router::CheckPrevEdges(router.GetGraph(), prev_edges.data())) {
+		return false;
+	}
+
+	router.GetRouter() = std::make_unique<Router>(router.GetGraph(), false);
+	auto& data = router.GetRouter()->GetRoutesInternalData();
+	data.weights.assign(router_proto.weights().begin(), router_proto.weights().end());
+	data.prev_edges = std::move(prev_edges);
+	return true;
+}
+
+bool DeSerializeRoutingTable(transport_router::TransportRouter& router, const transport_catalogue::TransportCatalogue& tc, const std::string& path,
+	uint64_t graph_fingerprint)
+{
+	std::unique_ptr<MappedFile> file;
+	try {
+		file = std::make_unique<MappedFile>(path);
+	}
+	catch (const std::runtime_error& error) {
+		std::cerr << error.what() << std::endl;
+		return false;
+	}
+
+	const char* data = file->GetData();
+	const uint64_t size = file->GetSize();
+
+	detail::RoutingTableHeader header{};
+	if (size < sizeof(header)) {
+		return false;
+	}
+	std::memcpy(&header, data, sizeof(header));
+
+	auto report_damaged = [&path]() {
+		std::cerr << "Routing table " << path << " is damaged or doesn't match the base" << std::endl;
+		return false;
+	};
+
+	// числа заголовка могут быть любыми: размеры секций считаются без переполнения
+	auto bytes_of = [](uint64_t count, uint64_t item_size, uint64_t& bytes) {
+		if (item_size != 0 && count > std::numeric_limits<uint64_t>::max() / item_size) {
+			return false;
+		}
+		bytes = count * item_size;
+		return true;
+	};
+	auto section_fits = [&](uint64_t offset, uint64_t bytes) {
+		return offset % detail::ROUTING_TABLE_ALIGNMENT == 0 && offset <= size && bytes <= size - offset;
+	};
+
+	uint64_t edges_bytes = 0;
+	uint64_t name_offsets_bytes = 0;
+	uint64_t cell_count = 0;
+	uint64_t weights_bytes = 0;
+	uint64_t prev_edges_bytes = 0;
+	if (!std::equal(std::begin(detail::ROUTING_TABLE_MAGIC), std::end(detail::ROUTING_TABLE_MAGIC), header.magic)
+		|| header.version != detail::ROUTING_TABLE_VERSION
+		|| header.file_size != size
+		|| header.graph_fingerprint != graph_fingerprint
+		// в модели LINEAR кроме остановок есть вершины поездки, как и в TransportRouter::InicializeGraph
+		|| (router.GetRouterSettings().graph_model_ == transport_router::GraphModel::LINEAR
+			? header.vertex_count < tc.GetAlltStops().size() : header.vertex_count != tc.GetAlltStops().size())
+		|| !bytes_of(header.edge_count, sizeof(detail::RoutingTableEdge), edges_bytes)
+		|| header.bus_count == std::numeric_limits<uint64_t>::max()
+		|| !bytes_of(header.bus_count + 1, sizeof(uint64_t), name_offsets_bytes)
+		|| !bytes_of(header.matrix_vertex_count, header.matrix_vertex_count, cell_count)
+		|| !bytes_of(cell_count, sizeof(double), weights_bytes)
+		|| !bytes_of(cell_count, sizeof(uint32_t), prev_edges_bytes)
+		|| !section_fits(header.edges_offset, edges_bytes)
+		|| !section_fits(header.bus_names_offset, name_offsets_bytes)
+		|| (header.matrix_vertex_count != 0 && header.matrix_vertex_count != header.vertex_count)
+		|| (cell_count != 0 && (!section_fits(header.weights_offset, weights_bytes)
+			|| !section_fits(header.prev_edges_offset, prev_edges_bytes)))) {
+		return report_damaged();
+	}
+
+	// смещения имён не убывают, и последнее не выходит за конец файла
+	const auto* name_offsets = reinterpret_cast<const uint64_t*>(data + header.bus_names_offset);
+	const uint64_t names_start = header.bus_names_offset + name_offsets_bytes;
+	for (uint64_t i = 0; i < header.bus_count; ++i) {
+		if (name_offsets[i] > name_offsets[i + 1]) {
+			return report_damaged();
+		}
+	}
+	if (name_offsets[header.bus_count] > size - names_start) {
+		return report_damaged();
+	}
+
+	const char* names = data + names_start;
+	std::vector<std::string_view> bus_names;
+	bus_names.reserve(header.bus_count);
+	for (uint64_t i = 0; i < header.bus_count; ++i) {
+		const domain::Bus* bus = tc.FindBus({ names + name_offsets[i], name_offsets[i + 1] - name_offsets[i] });
+		if (!bus) {
+			return report_damaged();
+		}
+		bus_names.push_back(bus->name);
+	}
+
+	const auto* edges = reinterpret_cast<const detail::RoutingTableEdge*>(data + header.edges_offset);
+	graph::DirectedWeightedGraph<transport_router::RouteWeight> graph(header.vertex_count);
+	graph.GetEdges().reserve(header.edge_count);
+	for (uint64_t i = 0; i < header.edge_count; ++i) {
+		const auto& edge = edges[i];
+		if (edge.from >= header.vertex_count || edge.to >= header.vertex_count || edge.bus >= header.bus_count) {
+			return report_damaged();
+		}
+		graph.AddEdge({ edge.from, edge.to, { edge.bus, static_cast<int>(edge.span_count), edge.total_time } });
+	}
+	try {
+		router.InicializeGraph(tc, std::move(graph), std::move(bus_names));
+	}
+	catch (const std::invalid_argument&) {
+		return report_damaged();
+	}
+	// отпечаток заголовка совпал, а рёбра могли быть повреждены
+	if (detail::ComputeGraphFingerprint(router) != graph_fingerprint) {
+		return report_damaged();
+	}
+
+	// матрица не копируется: Router читает её прямо из отображённого файла; цепочки предыдущих рёбер
+	// проверяются один раз здесь, чтобы BuildRoute не вышел за граф и не зациклился
+	if (cell_count != 0 && router.GetRouterSettings().routing_mode_ == transport_router::RoutingMode::ALL_PAIRS) {
+		if (!graph::Router<transport_router::RouteWeight>::CheckPrevEdges(router.GetGraph(),
+			reinterpret_cast<const uint32_t*>(data + header.prev_edges_offset))) {
+			return report_damaged();
+		}
+		router.GetRouter() = std::make_unique<graph::Router<transport_router::RouteWeight>>(router.GetGraph(),
+			reinterpret_cast<const double*>(data + header.weights_offset),
+			reinterpret_cast<const uint32_t*>(data + header.prev_edges_offset));
+	}
+	router.GetRoutingTableFile() = std::move(file);
+	return true;
+}
+
+void DeSerializeTransportRouter(transport_router::TransportRouter& router, const proto::TransportCatalogue& tc_proto, const transport_catalogue::TransportCatalogue& tc, const std::string& routing_table_path)
 {
 	if (!tc_proto.has_router()) {
 		return;
 	}
 
-	auto& p_settings = tc_proto.router().settings();
+	const auto& router_proto = tc_proto.router();
+	auto& p_settings = router_proto.settings();
 
-	router.AddRouterSetting({p_settings.bus_wait_time(), p_settings.bus_velocity()});
+	// режим и модель графа из повреждённой базы: настройки по умолчанию, граф строится заново
+	const bool settings_valid = proto::RoutingMode_IsValid(p_settings.routing_mode()) && proto::GraphModel_IsValid(p_settings.graph_model());
+	if (!settings_valid) {
+		std::cerr << "Routing settings in the base are damaged, default routing mode is used" << std::endl;
+	}
+	router.AddRouterSetting({p_settings.bus_wait_time(), p_settings.bus_velocity(),
+		settings_valid ? static_cast<transport_router::RoutingMode>(p_settings.routing_mode()) : transport_router::RoutingMode::ALL_PAIRS,
+		std::max<size_t>(1, p_settings.thread_count()),
+		settings_valid ? static_cast<transport_router::GraphModel>(p_settings.graph_model()) : transport_router::GraphModel::COMPLETE,
+		p_settings.lazy_row_budget() > 0 ? p_settings.lazy_row_budget() : transport_router::DEFAULT_LAZY_ROW_BUDGET,
+		p_settings.landmark_count() > 0 ? p_settings.landmark_count() : transport_router::DEFAULT_LANDMARK_COUNT});
+
+	bool graph_loaded = false;
+	bool router_loaded = false;
+	if (!settings_valid) {
+		router.InicializeGraph(tc);
+		return;
+	}
+	if (!routing_table_path.empty() && DeSerializeRoutingTable(router, tc, routing_table_path, router_proto.graph_fingerprint())) {
+		graph_loaded = true;
+		router_loaded = router.GetRouter() != nullptr;
+	}
+	if (!graph_loaded && router_proto.has_graph()) {
+		graph_loaded = DeSerializeGraph(router, router_proto.graph(), tc);
+	}
 
-	router.InicializeGraph(tc);
-	
+	// база без графа: строим всё заново
+	if (!graph_loaded) {
+		router.InicializeGraph(tc);
+		return;
+	}
+
+	if (!router_loaded) {
+		switch (router.GetRouterSettings().routing_mode_) {
+		case transport_router::RoutingMode::ALL_PAIRS:
+			router_loaded = router_proto.has_router() && DeSerializeRouter(router, router_proto.router());
+			break;
+		case transport_router::RoutingMode::CONTRACTION_HIERARCHY:
+			// поиск Дейкстры для матриц создаёт InicializeRouter; иерархию он строит, только если её нет в базе
+			if (router_proto.has_contraction_hierarchy()) {
+				DeSerializeContractionHierarchy(router, router_proto.contraction_hierarchy());
+			}
+			break;
+		case transport_router::RoutingMode::ALT:
+			// поиск Дейкстры над загруженными ориентирами создаёт InicializeRouter
+			if (router_proto.has_landmarks()) {
+				DeSerializeLandmarks(router, router_proto.landmarks());
+			}
+			break;
+		default:
+			break;
+		}
+	}
+
+	if (!router_loaded) {
+		router.InicializeRouter();
+	}
 }
 
-void DeSerialize(transport_catalogue::TransportCatalogue& tc, render::MapRenderer& map, transport_router::TransportRouter& router, std::istream& in)
+void DeSerialize(transport_catalogue::TransportCatalogue& tc, render::MapRenderer& map, transport_router::TransportRouter& router, std::istream& in, const std::string& routing_table_path)
 {
 	//LOG_DURATION("DeSerialize");
 
@@ -293,7 +792,7 @@ void DeSerialize(transport_catalogue::TransportCatalogue& tc, render::MapRendere
 
 	DeSerializeRenderProperties(map.GetRenderProperties(), tc_proto.render_setting());
 
-	DeSerializeTransportRouter(router, tc_proto, tc);
+	DeSerializeTransportRouter(router, tc_proto, tc, routing_table_path);
 }
 
 
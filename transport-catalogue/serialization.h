@@ -1,6 +1,7 @@
 #include "transport_catalogue.h"
 #include "map_renderer.h"
 #include "transport_router.h"
+#include "mapped_file.h"
 
 #include <transport_catalogue.pb.h>
 #include <svg.pb.h>
@@ -17,22 +18,41 @@ proto::Bus MakeBusToSerialize(const domain::Bus* bus, const transport_catalogue:
 
 proto::RenderProperties MakeRenderPropertiesToSerialize(const render::MapRenderer& map);
 
-proto::DirectedWeightedGraph MakeGraphToSerialize(const graph::DirectedWeightedGraph<transport_router::RouteWeight>& graph, const transport_catalogue::TransportCatalogue& tc);
+proto::DirectedWeightedGraph MakeGraphToSerialize(const transport_router::TransportRouter& router);
 
-proto::Router MakeRouterToSerialize(const std::unique_ptr<graph::Router<transport_router::RouteWeight>>& router);
+proto::Router MakeRouterToSerialize(const std::unique_ptr<graph::Router<transport_router::RouteWeight>>& router, size_t vertex_count);
 
-proto::TransportRouter MakeTransportRouterToSerialize(const transport_router::TransportRouter& router, const transport_catalogue::TransportCatalogue& tc);
+proto::ContractionHierarchy MakeContractionHierarchyToSerialize(const graph::ContractionHierarchy<transport_router::RouteWeight>& ch, size_t edge_count);
 
+proto::Landmarks MakeLandmarksToSerialize(const graph::Landmarks<transport_router::RouteWeight>& landmarks, size_t vertex_count);
 
-void Serialize(const transport_catalogue::TransportCatalogue& tc, const render::MapRenderer& map, const transport_router::TransportRouter& router, std::ostream& out);
+proto::TransportRouter MakeTransportRouterToSerialize(const transport_router::TransportRouter& router, bool serialize_routing_table);
+
+
+// serialize_routing_table = false: граф и таблица маршрутов пишутся отдельно через SerializeRoutingTable
+void Serialize(const transport_catalogue::TransportCatalogue& tc, const render::MapRenderer& map, const transport_router::TransportRouter& router, std::ostream& out, bool serialize_routing_table = true);
+
+void SerializeRoutingTable(const transport_router::TransportRouter& router, std::ostream& out);
 
 void DeSerializeTransportCatalogue(transport_catalogue::TransportCatalogue& tc, const proto::TransportCatalogue& tc_proto);
 
 void DeSerializeRenderProperties(render::RenderProperties& render_seting, const proto::RenderProperties& render_seting_proto);
 
-void DeSerializeTransportRouter(transport_router::TransportRouter& router, const proto::TransportCatalogue& tc_proto, const transport_catalogue::TransportCatalogue& tc);
+bool DeSerializeGraph(transport_router::TransportRouter& router, const proto::DirectedWeightedGraph& graph_proto, const transport_catalogue::TransportCatalogue& tc);
+
+bool DeSerializeRouter(transport_router::TransportRouter& router, const proto::Router& router_proto);
+
+bool DeSerializeContractionHierarchy(transport_router::TransportRouter& router, const proto::ContractionHierarchy& ch_proto);
+
+bool DeSerializeLandmarks(transport_router::TransportRouter& router, const proto::Landmarks& landmarks_proto);
+
+// graph_fingerprint - отпечаток графа из базы; файл от другого графа не загружается
+bool DeSerializeRoutingTable(transport_router::TransportRouter& router, const transport_catalogue::TransportCatalogue& tc, const std::string& path,
+	uint64_t graph_fingerprint);
+
+void DeSerializeTransportRouter(transport_router::TransportRouter& router, const proto::TransportCatalogue& tc_proto, const transport_catalogue::TransportCatalogue& tc, const std::string& routing_table_path);
 
-void DeSerialize(transport_catalogue::TransportCatalogue& tc, render::MapRenderer& map, transport_router::TransportRouter& router, std::istream& in);
+void DeSerialize(transport_catalogue::TransportCatalogue& tc, render::MapRenderer& map, transport_router::TransportRouter& router, std::istream& in, const std::string& routing_table_path = {});
 
 	
 }//namespace tc_project
\ No newline at end of file
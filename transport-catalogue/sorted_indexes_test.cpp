@@ -0,0 +1,108 @@
+#include "map_renderer.h"
+#include "serialization.h"
+#include "test_base.h"
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Проверка индексов по имени TransportCatalogue::GetSortedAllBuses и GetSortedAllStops: после заполнения
+// и после DeSerialize они совпадают с отсортированными именами входных данных, а добавление вне порядка
+// до следующего SortIndexes даёт std::logic_error вместо неупорядоченного списка
+
+using namespace tc_project;
+using namespace tc_project::test;
+using namespace std::literals;
+
+namespace {
+
+constexpr size_t STOP_COUNT = 40;
+constexpr size_t BUS_COUNT = 14;
+
+template <typename Item>
+std::vector<std::string> GetNames(const std::vector<Item*>& items) {
+	std::vector<std::string> names;
+	for (const Item* item : items) {
+		names.emplace_back(item->name);
+	}
+	return names;
+}
+
+// имена из input, отсортированные std::sort
+std::vector<std::string> SortNames(std::vector<std::string> names) {
+	std::sort(names.begin(), names.end());
+	return names;
+}
+
+size_t CheckIndexes(const transport_catalogue::TransportCatalogue& catalogue, const std::vector<std::string>& stop_names,
+	const std::vector<std::string>& bus_names, const std::string& context) {
+	size_t failures = 0;
+	failures += !Check(GetNames(catalogue.GetSortedAllStops()) == SortNames(stop_names), context + "stops aren't sorted by name"s);
+	failures += !Check(GetNames(catalogue.GetSortedAllBuses()) == SortNames(bus_names), context + "buses aren't sorted by name"s);
+	return failures;
+}
+
+template <typename Getter>
+bool Throws(Getter getter) {
+	try {
+		getter();
+	}
+	catch (const std::logic_error&) {
+		return true;
+	}
+	return false;
+}
+
+}//namespace
+
+int main() {
+	const TestBase base = MakeTestBase(STOP_COUNT, BUS_COUNT, 24);
+	std::vector<std::string> stop_names;
+	for (size_t stop = 0; stop < STOP_COUNT; ++stop) {
+		stop_names.push_back(StopName(stop));
+	}
+	std::vector<std::string> bus_names;
+	for (const BusDescription& bus : base.buses) {
+		bus_names.push_back(bus.name);
+	}
+
+	size_t failures = 0;
+	transport_catalogue::TransportCatalogue catalogue;
+	transport_router::TransportRouter router;
+	Fill(catalogue, router, base.MakeDocument(MakeRoutingSettings("dijkstra"s)));
+	failures += CheckIndexes(catalogue, stop_names, bus_names, "after filling: "s);
+
+	{
+		std::stringstream stream;
+		render::MapRenderer renderer;
+		Serialize(catalogue, renderer, router, stream);
+		transport_catalogue::TransportCatalogue loaded_catalogue;
+		render::MapRenderer loaded_renderer;
+		transport_router::TransportRouter loaded_router;
+		DeSerialize(loaded_catalogue, loaded_renderer, loaded_router, stream);
+		failures += CheckIndexes(loaded_catalogue, stop_names, bus_names, "after DeSerialize: "s);
+	}
+
+	// имена больше всех прежних не нарушают порядок
+	catalogue.AddStop("Z stop"sv, geo::Coordinates(55.7, 37.6));
+	catalogue.AddBus("Z bus"sv, { "Z stop"sv, StopName(0) }, false);
+	stop_names.push_back("Z stop"s);
+	bus_names.push_back("Z bus"s);
+	failures += CheckIndexes(catalogue, stop_names, bus_names, "after adding in order: "s);
+
+	// имя меньше прежних: до SortIndexes списка нет
+	catalogue.AddStop("A stop"sv, geo::Coordinates(55.8, 37.6));
+	stop_names.push_back("A stop"s);
+	failures += !Check(Throws([&catalogue]() { catalogue.GetSortedAllStops(); }), "unsorted stops were returned"s);
+	failures += !Check(!Throws([&catalogue]() { catalogue.GetSortedAllBuses(); }), "buses are reported unsorted after a stop was added"s);
+	catalogue.AddBus("A bus"sv, { "A stop"sv, "Z stop"sv, "A stop"sv }, true);
+	bus_names.push_back("A bus"s);
+	failures += !Check(Throws([&catalogue]() { catalogue.GetSortedAllBuses(); }), "unsorted buses were returned"s);
+
+	catalogue.SortIndexes();
+	failures += CheckIndexes(catalogue, stop_names, bus_names, "after SortIndexes: "s);
+
+	return Finish(failures);
+}
@@ -0,0 +1,216 @@
+#include "spatial_index.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace tc_project {
+
+namespace transport_catalogue {
+
+namespace {
+
+// те же константы, что в geo::ComputeDistance
+constexpr double DEG_TO_RAD = 3.1415926535 / 180.;
+constexpr double EARTH_RADIUS = 6371000;
+constexpr double PI = 3.1415926535;
+
+double ChordToMeters(double chord_sq) {
+	return 2 * std::asin(std::min(1.0, std::sqrt(chord_sq) / 2)) * EARTH_RADIUS;
+}
+
+double ChordSq(const double* lhs, const double* rhs) {
+	const double dx = lhs[0] - rhs[0];
+	const double dy = lhs[1] - rhs[1];
+	const double dz = lhs[2] - rhs[2];
+	return dx * dx + dy * dy + dz * dz;
+}
+
+}//namespace
+
+SpatialIndex::SpatialIndex(const std::vector<geo::Coordinates>& points)
+{
+	nodes_.reserve(points.size());
+	for (uint32_t id = 0; id < points.size(); ++id) {
+		nodes_.push_back(MakeNode(points[id], id));
+	}
+	Build(0, nodes_.size(), 0);
+}
+
+SpatialIndex::SpatialIndex(const std::vector<geo::Coordinates>& points, const std::vector<uint32_t>& order)
+{
+	if (order.size() != points.size()) {
+		throw std::invalid_argument("Spatial index doesn't match the stops");
+	}
+	std::vector<bool> seen(points.size(), false);
+	nodes_.reserve(order.size());
+	for (const uint32_t id : order) {
+		if (id >= points.size() || seen[id]) {
+			throw std::invalid_argument("Spatial index doesn't match the stops");
+		}
+		seen[id] = true;
+		nodes_.push_back(MakeNode(points[id], id));
+	}
+	// поиск отсекает половины по плоскостям раздела: с неверным порядком он молча пропустил бы точки
+	if (!IsTree(0, nodes_.size(), 0)) {
+		throw std::invalid_argument("Spatial index isn't a k-d tree of the stops");
+	}
+}
+
+SpatialIndex::Result SpatialIndex::FindNearest(geo::Coordinates point, size_t count) const
+{
+	if (count == 0) {
+		return {};
+	}
+	std::vector<std::pair<double, uint32_t>> heap;
+	heap.reserve(std::min(count, nodes_.size()));
+	SearchNearest(MakeNode(point, 0), 0, nodes_.size(), 0, count, heap);
+	return MakeResult(std::move(heap));
+}
+
+SpatialIndex::Result SpatialIndex::FindWithinRadius(geo::Coordinates point, double radius) const
+{
+	if (radius < 0) {
+		return {};
+	}
+	// хорда для дуги длиной radius, с запасом на округление; лишнее отсекается по расстоянию в метрах
+	const double angle = radius / EARTH_RADIUS;
+	const double max_chord = angle < PI ? 2 * std::sin(angle / 2) : 2.0;
+	const double max_chord_sq = max_chord * max_chord * (1 + 1e-9) + 1e-15;
+
+	std::vector<std::pair<double, uint32_t>> found;
+	SearchWithinRadius(MakeNode(point, 0), 0, nodes_.size(), 0, max_chord_sq, found);
+
+	Result result = MakeResult(std::move(found));
+	result.erase(std::find_if(result.begin(), result.end(), [radius](const auto& item) {
+		return item.second > radius;
+		}), result.end());
+	return result;
+}
+
+std::vector<uint32_t> SpatialIndex::GetOrder() const
+{
+	std::vector<uint32_t> order;
+	order.reserve(nodes_.size());
+	for (const Node& node : nodes_) {
+		order.push_back(node.id);
+	}
+	return order;
+}
+
+size_t SpatialIndex::GetSize() const
+{
+	return nodes_.size();
+}
+
+SpatialIndex::Node SpatialIndex::MakeNode(geo::Coordinates point, uint32_t id)
+{
+	const double lat = point.lat * DEG_TO_RAD;
+	const double lng = point.lng * DEG_TO_RAD;
+	return { { std::cos(lat) * std::cos(lng), std::cos(lat) * std::sin(lng), std::sin(lat) }, id };
+}
+
+void SpatialIndex::Build(size_t first, size_t last, size_t depth)
+{
+	if (last - first < 2) {
+		return;
+	}
+	const size_t axis = depth % 3;
+	const size_t mid = first + (last - first) / 2;
+	std::nth_element(nodes_.begin() + first, nodes_.begin() + mid, nodes_.begin() + last,
+		[axis](const Node& lhs, const Node& rhs) {
+			return lhs.axes[axis] < rhs.axes[axis];
+		});
+	Build(first, mid, depth + 1);
+	Build(mid + 1, last, depth + 1);
+}
+
+bool SpatialIndex::IsTree(size_t first, size_t last, size_t depth) const
+{
+	if (last - first < 2) {
+		return true;
+	}
+	const size_t axis = depth % 3;
+	const size_t mid = first + (last - first) / 2;
+	const double split = nodes_[mid].axes[axis];
+	for (size_t i = first; i < mid; ++i) {
+		if (nodes_[i].axes[axis] > split) {
+			return false;
+		}
+	}
+	for (size_t i = mid + 1; i < last; ++i) {
+		if (nodes_[i].axes[axis] < split) {
+			return false;
+		}
+	}
+	return IsTree(first, mid, depth + 1) && IsTree(mid + 1, last, depth + 1);
+}
+
+void SpatialIndex::SearchNearest(const Node& target, size_t first, size_t last, size_t depth, size_t count,
+	std::vector<std::pair<double, uint32_t>>& heap) const
+{
+	if (first >= last) {
+		return;
+	}
+	const size_t mid = first + (last - first) / 2;
+	const Node& node = nodes_[mid];
+
+	const std::pair<double, uint32_t> candidate{ ChordSq(target.axes, node.axes), node.id };
+	if (heap.size() < count) {
+		heap.push_back(candidate);
+		std::push_heap(heap.begin(), heap.end());
+	}
+	else if (candidate < heap.front()) {
+		std::pop_heap(heap.begin(), heap.end());
+		heap.back() = candidate;
+		std::push_heap(heap.begin(), heap.end());
+	}
+
+	// сначала половина со стороны точки; вторая - только если плоскость раздела ближе худшего из найденных
+	const size_t axis = depth % 3;
+	const double diff = target.axes[axis] - node.axes[axis];
+	const bool left_first = diff < 0;
+	SearchNearest(target, left_first ? first : mid + 1, left_first ? mid : last, depth + 1, count, heap);
+	if (heap.size() < count || diff * diff <= heap.front().first) {
+		SearchNearest(target, left_first ? mid + 1 : first, left_first ? last : mid, depth + 1, count, heap);
+	}
+}
+
+void SpatialIndex::SearchWithinRadius(const Node& target, size_t first, size_t last, size_t depth, double max_chord_sq,
+	std::vector<std::pair<double, uint32_t>>& found) const
+{
+	if (first >= last) {
+		return;
+	}
+	const size_t mid = first + (last - first) / 2;
+	const Node& node = nodes_[mid];
+
+	const double chord_sq = ChordSq(target.axes, node.axes);
+	if (chord_sq <= max_chord_sq) {
+		found.emplace_back(chord_sq, node.id);
+	}
+
+	const size_t axis = depth % 3;
+	const double diff = target.axes[axis] - node.axes[axis];
+	if (diff < 0 || diff * diff <= max_chord_sq) {
+		SearchWithinRadius(target, first, mid, depth + 1, max_chord_sq, found);
+	}
+	if (diff >= 0 || diff * diff <= max_chord_sq) {
+		SearchWithinRadius(target, mid + 1, last, depth + 1, max_chord_sq, found);
+	}
+}
+
+SpatialIndex::Result SpatialIndex::MakeResult(std::vector<std::pair<double, uint32_t>> found)
+{
+	std::sort(found.begin(), found.end());
+	Result result;
+	result.reserve(found.size());
+	for (const auto& [chord_sq, id] : found) {
+		result.emplace_back(id, ChordToMeters(chord_sq));
+	}
+	return result;
+}
+
+}//namespace transport_catalogue
+
+}//namespace tc_project
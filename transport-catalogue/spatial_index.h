@@ -0,0 +1,60 @@
+#pragma once
+
+#include "geo.h"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace tc_project {
+
+namespace transport_catalogue {
+
+// k-d дерево по точкам на сфере. Точка переводится в единичный вектор (x, y, z): хорда между векторами
+// растёт вместе с расстоянием по дуге, поэтому поиск идёт в обычной евклидовой метрике без особых случаев
+// у полюсов и линии перемены дат. Дерево неявное: порядок номеров точек, в котором середина отрезка -
+// узел, а оси чередуются x, y, z по глубине. Этот порядок и сохраняется в базе.
+class SpatialIndex {
+public:
+	// номер точки и расстояние до неё в метрах, по возрастанию расстояния, затем номера
+	using Result = std::vector<std::pair<uint32_t, double>>;
+
+	SpatialIndex() = default;
+	// points[i] - точка с номером i
+	explicit SpatialIndex(const std::vector<geo::Coordinates>& points);
+	// порядок, сохранённый в базе, см. GetOrder; std::invalid_argument, если это не перестановка точек
+	// или не k-d дерево по ним
+	SpatialIndex(const std::vector<geo::Coordinates>& points, const std::vector<uint32_t>& order);
+
+	Result FindNearest(geo::Coordinates point, size_t count) const;
+	Result FindWithinRadius(geo::Coordinates point, double radius) const;
+
+	std::vector<uint32_t> GetOrder() const;
+	size_t GetSize() const;
+
+private:
+	struct Node {
+		double axes[3];
+		uint32_t id;
+	};
+
+	static Node MakeNode(geo::Coordinates point, uint32_t id);
+
+	void Build(size_t first, size_t last, size_t depth);
+	// слева от узла по его оси нет точек больше него, справа - меньше; O(n log n)
+	bool IsTree(size_t first, size_t last, size_t depth) const;
+
+	// ближайшие count узлов в куче по квадрату хорды, самый дальний - наверху
+	void SearchNearest(const Node& target, size_t first, size_t last, size_t depth, size_t count,
+		std::vector<std::pair<double, uint32_t>>& heap) const;
+	void SearchWithinRadius(const Node& target, size_t first, size_t last, size_t depth, double max_chord_sq,
+		std::vector<std::pair<double, uint32_t>>& found) const;
+
+	static Result MakeResult(std::vector<std::pair<double, uint32_t>> found);
+
+	std::vector<Node> nodes_;// в порядке дерева
+};
+
+}//namespace transport_catalogue
+
+}//namespace tc_project
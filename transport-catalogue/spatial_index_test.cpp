@@ -0,0 +1,192 @@
+#include "spatial_index.h"
+#include "test_base.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Проверка transport_catalogue::SpatialIndex: ближайшие точки и точки в радиусе должны совпасть с перебором
+// всех точек через geo::ComputeDistance, в том числе у полюсов и линии перемены дат; порядок из GetOrder
+// восстанавливает то же дерево, а порядок, который не k-d дерево, отвергается
+
+using namespace tc_project;
+using namespace tc_project::test;
+using namespace std::literals;
+
+namespace {
+
+using transport_catalogue::SpatialIndex;
+
+// погрешность geo::ComputeDistance на малых расстояниях - доли метра
+constexpr double TOLERANCE = 1.0;
+
+const std::vector<size_t> COUNTS = { 0, 1, 5, 40, 1000 };
+const std::vector<double> RADII = { 0.0, 100.0, 10000.0, 1000000.0, 30000000.0 };
+
+// по всей сфере, скопления у полюсов и у линии перемены дат и повторы
+std::vector<geo::Coordinates> MakePoints(size_t count, uint32_t seed) {
+	std::mt19937 generator(seed);
+	std::uniform_real_distribution<double> unit(0.0, 1.0);
+	std::vector<geo::Coordinates> points;
+	while (points.size() < count) {
+		switch (points.size() % 5) {
+		case 0:
+			points.emplace_back(-90.0 + 180.0 * unit(generator), -180.0 + 360.0 * unit(generator));
+			break;
+		case 1:
+			points.emplace_back(89.9 + 0.1 * unit(generator), -180.0 + 360.0 * unit(generator));
+			break;
+		case 2:
+			points.emplace_back(-90.0 + 0.1 * unit(generator), -180.0 + 360.0 * unit(generator));
+			break;
+		case 3:
+			points.emplace_back(-1.0 + 2.0 * unit(generator), (unit(generator) < 0.5 ? -180.0 : 180.0) + 0.1 * (unit(generator) - 0.5));
+			break;
+		default:
+			points.push_back(points[generator() % points.size()]);
+		}
+	}
+	points.emplace_back(90.0, 0.0);
+	points.emplace_back(-90.0, 180.0);
+	return points;
+}
+
+// acos у geo::ComputeDistance даёт NaN, если из-за округления аргумент чуть больше единицы
+double ComputeDistanceOrZero(geo::Coordinates from, geo::Coordinates to) {
+	const double distance = geo::ComputeDistance(from, to);
+	return std::isnan(distance) ? 0.0 : distance;
+}
+
+// расстояния до всех точек по возрастанию
+std::vector<std::pair<double, uint32_t>> FindAllByScan(const std::vector<geo::Coordinates>& points, geo::Coordinates point) {
+	std::vector<std::pair<double, uint32_t>> all;
+	for (uint32_t id = 0; id < points.size(); ++id) {
+		all.emplace_back(ComputeDistanceOrZero(point, points[id]), id);
+	}
+	std::sort(all.begin(), all.end());
+	return all;
+}
+
+// результат по возрастанию, без повторов и с расстояниями как у перебора
+bool IsValidResult(const std::vector<geo::Coordinates>& points, geo::Coordinates point, const SpatialIndex::Result& result) {
+	std::vector<bool> seen(points.size(), false);
+	for (size_t i = 0; i < result.size(); ++i) {
+		const auto [id, distance] = result[i];
+		if (id >= points.size() || seen[id] || std::abs(distance - ComputeDistanceOrZero(point, points[id])) > TOLERANCE
+			|| (i > 0 && distance < result[i - 1].second)) {
+			return false;
+		}
+		seen[id] = true;
+	}
+	return true;
+}
+
+// первые count по перебору с точностью до равных в пределах погрешности расстояний
+bool IsSameNearest(const std::vector<std::pair<double, uint32_t>>& all, const SpatialIndex::Result& result, size_t count) {
+	if (result.size() != std::min(count, all.size())) {
+		return false;
+	}
+	for (size_t i = 0; i < result.size(); ++i) {
+		if (std::abs(result[i].second - all[i].first) > TOLERANCE) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// всё, что по перебору заметно ближе radius, найдено; найденное не дальше radius
+bool IsSameWithinRadius(const std::vector<std::pair<double, uint32_t>>& all, const SpatialIndex::Result& result, double radius) {
+	std::vector<bool> found(all.size(), false);
+	for (const auto& [id, distance] : result) {
+		if (distance > radius) {
+			return false;
+		}
+		found[id] = true;
+	}
+	for (const auto& [distance, id] : all) {
+		if (distance < radius - TOLERANCE && !found[id]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// запросы у точек, между ними, у полюсов и линии перемены дат
+std::vector<geo::Coordinates> MakeQueries(const std::vector<geo::Coordinates>& points, uint32_t seed) {
+	std::vector<geo::Coordinates> queries = { { 90.0, 0.0 }, { -90.0, 0.0 }, { 0.0, 180.0 }, { 0.0, -180.0 }, { 0.5, 179.99 } };
+	for (size_t i = 0; i < points.size(); i += 7) {
+		queries.push_back(points[i]);
+	}
+	const std::vector<geo::Coordinates> random_points = MakePoints(60, seed);
+	queries.insert(queries.end(), random_points.begin(), random_points.end());
+	return queries;
+}
+
+size_t CountMismatches(const SpatialIndex& index, const std::vector<geo::Coordinates>& points, const std::vector<geo::Coordinates>& queries) {
+	size_t mismatches = 0;
+	for (const geo::Coordinates query : queries) {
+		const auto all = FindAllByScan(points, query);
+		for (const size_t count : COUNTS) {
+			const auto result = index.FindNearest(query, count);
+			mismatches += !IsValidResult(points, query, result) || !IsSameNearest(all, result, count);
+		}
+		for (const double radius : RADII) {
+			const auto result = index.FindWithinRadius(query, radius);
+			mismatches += !IsValidResult(points, query, result) || !IsSameWithinRadius(all, result, radius);
+		}
+	}
+	return mismatches;
+}
+
+template <typename Factory>
+bool IsRejected(Factory factory) {
+	try {
+		factory();
+	}
+	catch (const std::invalid_argument&) {
+		return true;
+	}
+	return false;
+}
+
+}//namespace
+
+int main() {
+	const std::vector<geo::Coordinates> points = MakePoints(500, 25);
+	const std::vector<geo::Coordinates> queries = MakeQueries(points, 2025);
+
+	size_t failures = 0;
+	const SpatialIndex index(points);
+	failures += !Check(index.GetSize() == points.size(), "index size differs from the point count"s);
+	const size_t mismatches = CountMismatches(index, points, queries);
+	failures += !Check(mismatches == 0, std::to_string(mismatches) + " search(es) differ from the scan"s);
+
+	// порядок из базы
+	const std::vector<uint32_t> order = index.GetOrder();
+	const SpatialIndex loaded_index(points, order);
+	failures += !Check(loaded_index.GetOrder() == order && CountMismatches(loaded_index, points, queries) == 0,
+		"index loaded from GetOrder differs"s);
+
+	std::vector<uint32_t> reversed_order(order.rbegin(), order.rend());
+	failures += !Check(IsRejected([&]() { SpatialIndex loaded(points, reversed_order); }), "order that isn't a k-d tree was accepted"s);
+	// узлы поменяны местами внутри левой половины: раздел у корня верный, нарушен ниже
+	std::vector<uint32_t> swapped_order = order;
+	std::swap(swapped_order.front(), swapped_order[order.size() / 2 - 1]);
+	failures += !Check(IsRejected([&]() { SpatialIndex loaded(points, swapped_order); }), "order broken below the root was accepted"s);
+	std::vector<uint32_t> repeated_order = order;
+	repeated_order.back() = repeated_order.front();
+	failures += !Check(IsRejected([&]() { SpatialIndex loaded(points, repeated_order); }), "order with a repeated point was accepted"s);
+	failures += !Check(IsRejected([&]() { SpatialIndex loaded(points, std::vector<uint32_t>(order.begin(), order.end() - 1)); }),
+		"order of another size was accepted"s);
+
+	// пустой индекс ничего не находит
+	const SpatialIndex empty_index(std::vector<geo::Coordinates>{});
+	failures += !Check(empty_index.FindNearest({ 0.0, 0.0 }, 3).empty() && empty_index.FindWithinRadius({ 0.0, 0.0 }, 1e7).empty(),
+		"empty index found points"s);
+
+	return Finish(failures);
+}
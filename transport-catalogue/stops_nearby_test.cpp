@@ -0,0 +1,94 @@
+#include "test_base.h"
+
+#include <map>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+// Проверка TransportCatalogue::GetStopsNearby: соседи остановки по списку смежности должны совпасть
+// с перебором всех пар остановок, как в прежнем каталоге на std::map: расстояние в обратную сторону
+// записывается из прямого, если его ещё нет
+
+using namespace tc_project;
+using namespace tc_project::test;
+using namespace std::literals;
+
+namespace {
+
+constexpr size_t STOP_COUNT = 60;
+constexpr size_t BUS_COUNT = 20;
+
+using DistanceModel = std::map<std::pair<size_t, size_t>, unsigned int>;
+
+// то же правило, что у TransportCatalogue::AddDistanceFromTo
+void AddDistance(DistanceModel& model, size_t from, size_t to, unsigned int distance) {
+	model[{ from, to }] = distance;
+	model.emplace(std::pair(to, from), distance);
+}
+
+// перебор всех пар модели с началом в from
+std::unordered_map<std::string, unsigned int> FindStopsNearbyByScan(const DistanceModel& model, size_t from) {
+	std::unordered_map<std::string, unsigned int> stops;
+	for (const auto& [stops_pair, distance] : model) {
+		if (stops_pair.first == from) {
+			stops[StopName(stops_pair.second)] = distance;
+		}
+	}
+	return stops;
+}
+
+size_t CountMismatches(const transport_catalogue::TransportCatalogue& catalogue, const DistanceModel& model) {
+	size_t mismatches = 0;
+	for (size_t stop = 0; stop < STOP_COUNT; ++stop) {
+		const auto expected = FindStopsNearbyByScan(model, stop);
+		const auto nearby = catalogue.GetStopsNearby(catalogue.FindStop(StopName(stop)));
+		if (nearby.size() != expected.size()) {
+			++mismatches;
+			continue;
+		}
+		for (const auto& [name, distance] : nearby) {
+			const auto it = expected.find(std::string(name));
+			mismatches += it == expected.end() || it->second != distance;
+		}
+	}
+	return mismatches;
+}
+
+}//namespace
+
+int main() {
+	const TestBase base = MakeTestBase(STOP_COUNT, BUS_COUNT, 20);
+
+	// заданные расстояния записываются раньше обратных: порядок входных данных не важен
+	DistanceModel model(base.road_distances.begin(), base.road_distances.end());
+	for (const auto& [stops_pair, distance] : base.road_distances) {
+		model.emplace(std::pair(stops_pair.second, stops_pair.first), distance);
+	}
+
+	size_t failures = 0;
+	{
+		transport_catalogue::TransportCatalogue catalogue;
+		transport_router::TransportRouter router;
+		Fill(catalogue, router, base.MakeDocument(MakeRoutingSettings("dijkstra"s)));
+		const size_t mismatches = CountMismatches(catalogue, model);
+		failures += !Check(mismatches == 0, std::to_string(mismatches) + " stop(s) with neighbours different from the scan"s);
+
+		// новые и повторные расстояния после заполнения; повторное заменяет прежнее только в одну сторону
+		for (size_t i = 0; i < 10; ++i) {
+			const size_t from = i % STOP_COUNT;
+			const size_t to = (i * 7 + 3) % STOP_COUNT;
+			catalogue.AddDistanceFromTo(StopName(from), StopName(to), 500 + static_cast<unsigned int>(i));
+			AddDistance(model, from, to, 500 + static_cast<unsigned int>(i));
+		}
+		const size_t updated_mismatches = CountMismatches(catalogue, model);
+		failures += !Check(updated_mismatches == 0, std::to_string(updated_mismatches) + " stop(s) differ after more distances are added"s);
+	}
+
+	// у остановки без расстояний соседей нет
+	transport_catalogue::TransportCatalogue catalogue;
+	catalogue.AddStop("Lonely stop"sv, geo::Coordinates(55.7, 37.6));
+	failures += !Check(catalogue.GetStopsNearby(catalogue.FindStop("Lonely stop"sv)).empty(), "stop without distances has neighbours"s);
+
+	return Finish(failures);
+}
@@ -0,0 +1,210 @@
+#pragma once
+
+#include "geo.h"
+#include "json.h"
+#include "json_reader.h"
+#include "transport_catalogue.h"
+#include "transport_router.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Общее для тестов: случайная, но воспроизводимая по seed база и проверка с сообщением в std::cerr
+
+namespace tc_project {
+
+namespace test {
+
+using namespace std::literals;
+
+struct BusDescription {
+	std::string name;
+	std::vector<size_t> stops;// как во входных данных: у кольцевого первая остановка равна последней
+	bool is_roundtrip;
+};
+
+struct TestBase {
+	std::vector<geo::Coordinates> stops;// координаты остановки StopName(i)
+	std::vector<BusDescription> buses;
+	std::map<std::pair<size_t, size_t>, int> road_distances;// как во входных данных, в одну сторону
+
+	// остановки и автобусы идут в base_requests вперемешку, не по порядку имён
+	json::Document MakeDocument(const json::Dict& routing_settings, json::Array stat_requests = {}) const;
+};
+
+inline std::string StopName(size_t index) {
+	return "Stop "s + std::to_string(index);
+}
+
+inline std::string BusName(size_t index) {
+	return "Bus "s + std::to_string(index);
+}
+
+// stop_count остановок в квадрате около 10 км, bus_count автобусов по 3-8 остановок. Расстояние задано
+// для соседних остановок маршрутов, иногда и в обратную сторону другое, и для нескольких случайных пар.
+// Последняя остановка без автобусов: маршрутов до неё и от неё нет
+inline TestBase MakeTestBase(size_t stop_count, size_t bus_count, uint32_t seed) {
+	std::mt19937 generator(seed);
+	const auto random_index = [&generator](size_t count) {
+		return static_cast<size_t>(generator() % count);
+	};
+	const auto random_unit = [&generator]() {
+		return static_cast<double>(generator()) / generator.max();
+	};
+
+	TestBase base;
+	for (size_t stop = 0; stop < stop_count; ++stop) {
+		base.stops.emplace_back(55.7 + 0.09 * random_unit(), 37.5 + 0.16 * random_unit());
+	}
+
+	const auto add_distance = [&](size_t from, size_t to) {
+		if (!base.road_distances.count({ from, to })) {
+			const double distance = geo::ComputeDistance(base.stops[from], base.stops[to]) * (1.05 + 0.5 * random_unit());
+			base.road_distances[{ from, to }] = std::max(1, static_cast<int>(std::ceil(distance)));
+		}
+	};
+
+	const size_t route_stop_count = stop_count - 1;
+	for (size_t bus = 0; bus < bus_count; ++bus) {
+		BusDescription description{ BusName(bus), {}, random_index(3) == 0 };
+		const size_t length = 3 + random_index(6);
+		description.stops.push_back(random_index(route_stop_count));
+		while (description.stops.size() < length) {
+			const size_t stop = random_index(route_stop_count);
+			if (stop != description.stops.back()) {
+				description.stops.push_back(stop);
+			}
+		}
+		if (description.is_roundtrip) {
+			description.stops.push_back(description.stops.front());
+		}
+		for (size_t i = 0; i + 1 < description.stops.size(); ++i) {
+			add_distance(description.stops[i], description.stops[i + 1]);
+			if (random_index(3) == 0) {
+				add_distance(description.stops[i + 1], description.stops[i]);
+			}
+		}
+		base.buses.push_back(std::move(description));
+	}
+	for (size_t pair = 0; pair < stop_count; ++pair) {
+		const size_t from = random_index(stop_count);
+		const size_t to = random_index(stop_count);
+		if (from != to) {
+			add_distance(from, to);
+		}
+	}
+	return base;
+}
+
+inline json::Document TestBase::MakeDocument(const json::Dict& routing_settings, json::Array stat_requests) const {
+	std::vector<json::Dict> stop_distances(stops.size());
+	for (const auto& [stops_pair, distance] : road_distances) {
+		stop_distances[stops_pair.first][StopName(stops_pair.second)] = distance;
+	}
+
+	json::Array base_requests;
+	for (size_t i = 0; i < std::max(stops.size(), buses.size()); ++i) {
+		// с конца, чтобы номера в каталоге не совпали с номерами в именах
+		if (i < buses.size()) {
+			const BusDescription& bus = buses[buses.size() - 1 - i];
+			json::Array bus_stops;
+			for (const size_t stop : bus.stops) {
+				bus_stops.push_back(StopName(stop));
+			}
+			base_requests.push_back(json::Dict{
+				{ "type"s, "Bus"s },
+				{ "name"s, bus.name },
+				{ "stops"s, bus_stops },
+				{ "is_roundtrip"s, bus.is_roundtrip },
+			});
+		}
+		if (i < stops.size()) {
+			const size_t stop = stops.size() - 1 - i;
+			base_requests.push_back(json::Dict{
+				{ "type"s, "Stop"s },
+				{ "name"s, StopName(stop) },
+				{ "latitude"s, stops[stop].lat },
+				{ "longitude"s, stops[stop].lng },
+				{ "road_distances"s, std::move(stop_distances[stop]) },
+			});
+		}
+	}
+	return json::Document{ json::Dict{
+		{ "base_requests"s, base_requests },
+		{ "routing_settings"s, routing_settings },
+		{ "stat_requests"s, stat_requests },
+	} };
+}
+
+inline json::Dict MakeRoutingSettings(const std::string& routing_mode, const std::string& graph_model = "complete"s) {
+	return json::Dict{
+		{ "bus_wait_time"s, 6 },
+		{ "bus_velocity"s, 40 },
+		{ "routing_mode"s, routing_mode },
+		{ "graph_model"s, graph_model },
+	};
+}
+
+inline void Fill(transport_catalogue::TransportCatalogue& catalogue, transport_router::TransportRouter& router, const json::Document& document) {
+	JesonReader reader(document);
+	reader.FiilCatalogue(catalogue);
+	reader.FillRouteProperties(router, catalogue);
+}
+
+inline bool IsSameTime(double lhs, double rhs) {
+	return std::abs(lhs - rhs) <= 1e-9 * std::max(1.0, std::abs(rhs));
+}
+
+// время route совпадает с expected, а рёбра route идут одно за другим от from до to;
+// при равном времени путь может быть другим
+inline bool IsSameRoute(const graph::DirectedWeightedGraph<transport_router::RouteWeight>& graph, graph::VertexId from, graph::VertexId to,
+	const std::optional<graph::Router<transport_router::RouteWeight>::RouteInfo>& route,
+	const std::optional<graph::Router<transport_router::RouteWeight>::RouteInfo>& expected) {
+	if (route.has_value() != expected.has_value()) {
+		return false;
+	}
+	if (!route) {
+		return true;
+	}
+	graph::VertexId vertex = from;
+	double total_time = 0.0;
+	for (const graph::EdgeId edge_id : route->edges) {
+		const auto& edge = graph.GetEdge(edge_id);
+		if (edge.from != vertex) {
+			return false;
+		}
+		vertex = edge.to;
+		total_time += edge.weight.total_time;
+	}
+	return vertex == to && IsSameTime(route->weight.total_time, expected->weight.total_time) && IsSameTime(total_time, route->weight.total_time);
+}
+
+// false и сообщение в std::cerr, если проверка не прошла
+inline bool Check(bool condition, const std::string& message) {
+	if (!condition) {
+		std::cerr << message << std::endl;
+	}
+	return condition;
+}
+
+inline int Finish(size_t failures) {
+	if (failures > 0) {
+		std::cerr << failures << " check(s) failed"s << std::endl;
+		return EXIT_FAILURE;
+	}
+	std::cout << "OK"s << std::endl;
+	return EXIT_SUCCESS;
+}
+
+}//namespace test
+
+}//namespace tc_project
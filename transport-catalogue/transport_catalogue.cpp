@@ -1,4 +1,5 @@
 ﻿#include <algorithm>
+#include <stdexcept>
 
 #include "transport_catalogue.h"
 
@@ -6,14 +7,47 @@ namespace tc_project {
 
 namespace transport_catalogue {
 
+UniqueStopCounter::UniqueStopCounter(const size_t stop_count, const uint32_t epoch)
+	: stop_visit_epoch_(stop_count, epoch)
+	, visit_epoch_(epoch)
+{
+}
+
+size_t UniqueStopCounter::Count(const uint32_t* first, const uint32_t* last)
+{
+	if (++visit_epoch_ == 0) {
+		std::fill(stop_visit_epoch_.begin(), stop_visit_epoch_.end(), 0);
+		visit_epoch_ = 1;
+	}
+
+	size_t unique_stops = 0;
+	for (const uint32_t* stop = first; stop != last; ++stop) {
+		if (stop_visit_epoch_.at(*stop) != visit_epoch_) {
+			stop_visit_epoch_[*stop] = visit_epoch_;
+			++unique_stops;
+		}
+	}
+	return unique_stops;
+}
+
 void TransportCatalogue::AddStop(const std::string_view name, const geo::Coordinates coordinates)
 {
 	if (StopExists(name)) {
 		return;
 	}
 
-	list_of_stops_.emplace_back(std::string(name), coordinates.lat, coordinates.lng);
+	const auto stop_id = static_cast<uint32_t>(list_of_stops_.size());
+	list_of_stops_.emplace_back(std::string(name), coordinates.lat, coordinates.lng, stop_id);
 	map_of_stops_[list_of_stops_.back().name] = &list_of_stops_.back();
+
+	if (!sorted_stops_.empty() && list_of_stops_.back().name < sorted_stops_.back()->name) {
+		stops_sorted_ = false;
+	}
+	sorted_stops_.push_back(&list_of_stops_.back());
+
+	stop_coordinates_.push_back(coordinates);
+	buses_on_stop_.emplace_back();
+	distance_neighbours_.emplace_back();
 }
 
 
@@ -30,32 +64,63 @@ void TransportCatalogue::AddBus(const std::string_view bus_name, const std::vect
 			st.push_back(map_of_stops_.at(stop_name));
 		});
 	
-	list_of_bus_.emplace_back(domain::Bus(bus_name, st, is_roundtrip));
+	bus_infos_.clear();
+
+	const auto bus_id = static_cast<uint32_t>(list_of_bus_.size());
+	list_of_bus_.emplace_back(domain::Bus(bus_name, st, is_roundtrip, bus_id));
 	map_of_bus_[list_of_bus_.back().name] = &list_of_bus_.back();
-		
-	std::for_each(st.begin(), st.end(),
-		[&](domain::Stop* stop_ptr) {
-			map_bus_on_stop_[stop_ptr].insert(map_of_bus_.at(bus_name));
-		});
+
+	if (!sorted_buses_.empty() && list_of_bus_.back().name < sorted_buses_.back()->name) {
+		buses_sorted_ = false;
+	}
+	sorted_buses_.push_back(&list_of_bus_.back());
+
+	for (const domain::Stop* stop_ptr : st) {
+		route_stops_.push_back(stop_ptr->id);
+	}
+	route_offsets_.push_back(static_cast<uint32_t>(route_stops_.size()));
+
+	const auto by_name = [this](uint32_t lhs, uint32_t rhs) {
+		return list_of_bus_[lhs].name < list_of_bus_[rhs].name;
+	};
+	for (const domain::Stop* stop_ptr : st) {
+		auto& buses = buses_on_stop_[stop_ptr->id];
+		const auto it = std::lower_bound(buses.begin(), buses.end(), bus_id, by_name);
+		if (it == buses.end() || *it != bus_id) {
+			buses.insert(it, bus_id);
+		}
+	}
 }
 
 void TransportCatalogue::AddDistanceFromTo(const std::string_view current_stop_name, const std::string_view other_stop_name, const unsigned int distance_to_stops)
 {
-	map_distance_between_stops[std::make_pair(map_of_stops_.at(current_stop_name), map_of_stops_.at(other_stop_name))] = distance_to_stops;
+	const uint32_t current_id = map_of_stops_.at(current_stop_name)->id;
+	const uint32_t other_id = map_of_stops_.at(other_stop_name)->id;
+	bus_infos_.clear();
 
-	if (map_distance_between_stops.find(std::make_pair(map_of_stops_.at(other_stop_name), map_of_stops_.at(current_stop_name))) == map_distance_between_stops.end()) {
-		map_distance_between_stops[std::make_pair(map_of_stops_.at(other_stop_name), map_of_stops_.at(current_stop_name))] = distance_to_stops;
+	const auto [forward, forward_added] = map_distance_between_stops.Emplace(MakeDistanceKey(current_id, other_id), distance_to_stops);
+	if (forward_added) {
+		distance_neighbours_[current_id].push_back(other_id);
+	}
+	else {
+		*forward = distance_to_stops;
+	}
+
+	if (map_distance_between_stops.Emplace(MakeDistanceKey(other_id, current_id), distance_to_stops).second) {
+		distance_neighbours_[other_id].push_back(current_id);
 	}
 }
 
 const domain::Bus* TransportCatalogue::FindBus(const std::string_view name) const
 {
-	return map_of_bus_.find(name) != map_of_bus_.end() ? map_of_bus_.at(name) : nullptr;
+	const auto it = map_of_bus_.find(name);
+	return it != map_of_bus_.end() ? it->second : nullptr;
 }
 
 const domain::Stop* TransportCatalogue::FindStop(const std::string_view name) const
 {
-	return map_of_stops_.find(name) != map_of_stops_.end() ? map_of_stops_.at(name) : nullptr;
+	const auto it = map_of_stops_.find(name);
+	return it != map_of_stops_.end() ? it->second : nullptr;
 }
 
 std::optional<domain::BusInfo>  TransportCatalogue::GetBusInfo(const std::string_view name) const
@@ -66,68 +131,93 @@ std::optional<domain::BusInfo>  TransportCatalogue::GetBusInfo(const std::string
 		return std::nullopt;
 	}
 
-	double real_lenght = *GetRoadDistance(name);
+	if (!bus_infos_.empty() && bus_infos_[bus_ptr->id]) {
+		return bus_infos_[bus_ptr->id];
+	}
+	// счётчик на один запрос: константный метод не меняет общих данных
+	UniqueStopCounter unique_stop_counter(list_of_stops_.size());
+	return MakeBusInfo(bus_ptr->id, unique_stop_counter);
+}
+
+domain::BusInfo TransportCatalogue::MakeBusInfo(const uint32_t bus_id, UniqueStopCounter& unique_stop_counter) const
+{
+	double real_lenght = *GetRoadDistance(list_of_bus_[bus_id].name);
 	double route_curvature = 0;
-	
-	std::vector<std::string_view> unique_stops_tmp;
-	unique_stops_tmp.reserve(bus_ptr->stop_on_route.size());
 
-	for (size_t i = 0; i < bus_ptr->stop_on_route.size(); ++i) {
-		if (i + 1 < bus_ptr->stop_on_route.size()) {
-			route_curvature += geo::ComputeDistance(bus_ptr->stop_on_route[i]->coordinates, bus_ptr->stop_on_route[i + 1]->coordinates);
-		}
-		unique_stops_tmp.push_back(bus_ptr->stop_on_route[i]->name);
-	}
+	const uint32_t* const first = route_stops_.data() + route_offsets_[bus_id];
+	const uint32_t* const last = route_stops_.data() + route_offsets_[bus_id + 1];
 
-	//узкое место 
-	std::sort(unique_stops_tmp.begin(), unique_stops_tmp.end());
-	unique_stops_tmp.erase(std::unique(unique_stops_tmp.begin(), unique_stops_tmp.end()), unique_stops_tmp.end());
+	for (const uint32_t* stop = first; stop + 1 < last; ++stop) {
+		route_curvature += geo::ComputeDistance(stop_coordinates_[stop[0]], stop_coordinates_[stop[1]]);
+	}
 
-	return domain::BusInfo(bus_ptr->stop_on_route.size(), unique_stops_tmp.size(), real_lenght, (real_lenght / route_curvature));
+	return domain::BusInfo(last - first, unique_stop_counter.Count(first, last), real_lenght, (real_lenght / route_curvature));
 }
 
 std::optional <domain::StopInfo> TransportCatalogue::GetStopInfo(const std::string_view name) const
 {
-	if (!StopExists(name)) {
+	const domain::Stop* stop_ptr = FindStop(name);
+	if (!stop_ptr) {
 		return std::nullopt;
 	}
 
-	std::vector<domain::Bus*> buses_tmp;
-	if (map_bus_on_stop_.find(map_of_stops_.at(name)) != map_bus_on_stop_.end()) {
-		buses_tmp.reserve(map_bus_on_stop_.at(map_of_stops_.at(name)).size());
-		buses_tmp.assign(map_bus_on_stop_.at(map_of_stops_.at(name)).begin(), map_bus_on_stop_.at(map_of_stops_.at(name)).end());
+	const auto& bus_ids = buses_on_stop_[stop_ptr->id];
+	std::vector<const domain::Bus*> buses_tmp;
+	buses_tmp.reserve(bus_ids.size());
+	for (const uint32_t bus_id : bus_ids) {
+		buses_tmp.push_back(&list_of_bus_[bus_id]);
 	}
 
-	return domain::StopInfo(map_of_stops_.at(name)->name, buses_tmp);
+	return domain::StopInfo(stop_ptr->name, std::move(buses_tmp));
 }
 
 std::optional<double> TransportCatalogue::GetRoadDistance(const std::string_view bus_name) const
 {
 	double real_distance = 0.0;
-	auto& route = map_of_bus_.at(bus_name)->stop_on_route;
-	for (size_t i = 0; i + 1 < route.size(); ++i) {
-		real_distance += map_distance_between_stops.at(std::make_pair(route[i], route[i + 1]));
+	const uint32_t bus_id = map_of_bus_.at(bus_name)->id;
+	for (uint32_t i = route_offsets_[bus_id]; i + 1 < route_offsets_[bus_id + 1]; ++i) {
+		const unsigned int* distance = map_distance_between_stops.Find(MakeDistanceKey(route_stops_[i], route_stops_[i + 1]));
+		if (!distance) {
+			throw std::out_of_range("No road distance between stops");
+		}
+		real_distance += *distance;
 	}
 
 	return real_distance;
 }
 
-std::optional<std::vector<domain::Bus*>> TransportCatalogue::GetSortedAllBuses() const
+const std::vector<domain::Bus*>& TransportCatalogue::GetSortedAllBuses() const
 {
-	std::vector<domain::Bus*> all_buses;
-	all_buses.reserve(map_of_bus_.size());
-
-	std::transform(map_of_bus_.cbegin(), map_of_bus_.cend(), std::back_inserter(all_buses),
-		[](const auto& key_bus){
-			return key_bus.second;
-		});
+	if (!buses_sorted_) {
+		throw std::logic_error("Buses were added after SortIndexes");
+	}
+	return sorted_buses_;
+}
 
-	std::sort(all_buses.begin(), all_buses.end(),
-		[](auto& lhs, auto& rhs){
-			return static_cast<std::string_view>(lhs->name) < static_cast<std::string_view>(rhs->name);
-		});
+const std::vector<domain::Stop*>& TransportCatalogue::GetSortedAllStops() const
+{
+	if (!stops_sorted_) {
+		throw std::logic_error("Stops were added after SortIndexes");
+	}
+	return sorted_stops_;
+}
 
-	return all_buses;
+void TransportCatalogue::SortIndexes()
+{
+	if (!buses_sorted_) {
+		std::sort(sorted_buses_.begin(), sorted_buses_.end(),
+			[](const domain::Bus* lhs, const domain::Bus* rhs) {
+				return lhs->name < rhs->name;
+			});
+		buses_sorted_ = true;
+	}
+	if (!stops_sorted_) {
+		std::sort(sorted_stops_.begin(), sorted_stops_.end(),
+			[](const domain::Stop* lhs, const domain::Stop* rhs) {
+				return lhs->name < rhs->name;
+			});
+		stops_sorted_ = true;
+	}
 }
 
 const std::unordered_map<std::string_view, domain::Bus*>& TransportCatalogue::GetAllBuses() const
@@ -142,13 +232,15 @@ const std::unordered_map<std::string_view, domain::Stop*>& TransportCatalogue::G
 
 double TransportCatalogue::GetStopsDistance(const std::pair<domain::Stop*, domain::Stop*> start_stop_point) const
 {
-	auto it = map_distance_between_stops.find(start_stop_point);
-	it = (it == map_distance_between_stops.end()) ? map_distance_between_stops.find({ start_stop_point.second, start_stop_point.first }) : it;
-	if (it != map_distance_between_stops.end()) {
-		return it->second;
+	auto distance = FindDistance(start_stop_point.first->id, start_stop_point.second->id);
+	if (!distance) {
+		distance = FindDistance(start_stop_point.second->id, start_stop_point.first->id);
+	}
+	if (distance) {
+		return *distance;
 	}
 	else {
-		return geo::ComputeDistance(start_stop_point.first->coordinates, start_stop_point.first->coordinates);
+		return geo::ComputeDistance(stop_coordinates_[start_stop_point.first->id], stop_coordinates_[start_stop_point.first->id]);
 	}
 
 }
@@ -157,10 +249,10 @@ const std::unordered_map<std::string_view, unsigned int> TransportCatalogue::Get
 {
 	std::unordered_map<std::string_view, unsigned int> stops_nearby;
 
-	for (const auto [stops, distance] : map_distance_between_stops) {
-		if (stops.first == stop) {
-			stops_nearby.emplace(stops.second->name, distance);
-		}
+	const auto& neighbours = distance_neighbours_[stop->id];
+	stops_nearby.reserve(neighbours.size());
+	for (const uint32_t other_id : neighbours) {
+		stops_nearby.emplace(list_of_stops_[other_id].name, *FindDistance(stop->id, other_id));
 	}
 
 	return stops_nearby;
@@ -176,6 +268,128 @@ bool TransportCatalogue::StopExists(std::string_view name) const
 	return map_of_stops_.find(name) != map_of_stops_.end();
 }
 
+size_t TransportCatalogue::GetStopCount() const
+{
+	return list_of_stops_.size();
+}
+
+size_t TransportCatalogue::GetBusCount() const
+{
+	return list_of_bus_.size();
+}
+
+const domain::Stop& TransportCatalogue::GetStop(const uint32_t stop_id) const
+{
+	if (stop_id >= list_of_stops_.size()) {
+		throw std::out_of_range("Stop id is out of range");
+	}
+	return list_of_stops_[stop_id];
+}
+
+const domain::Bus& TransportCatalogue::GetBus(const uint32_t bus_id) const
+{
+	if (bus_id >= list_of_bus_.size()) {
+		throw std::out_of_range("Bus id is out of range");
+	}
+	return list_of_bus_[bus_id];
+}
+
+const std::vector<uint32_t>& TransportCatalogue::GetBusesOnStop(const uint32_t stop_id) const
+{
+	if (stop_id >= buses_on_stop_.size()) {
+		throw std::out_of_range("Stop id is out of range");
+	}
+	return buses_on_stop_[stop_id];
+}
+
+void TransportCatalogue::ComputeBusInfo()
+{
+	std::vector<std::optional<domain::BusInfo>> bus_infos;
+	bus_infos.reserve(list_of_bus_.size());
+	// один счётчик на все автобусы: отметки не обнуляются между маршрутами
+	UniqueStopCounter unique_stop_counter(list_of_stops_.size());
+	for (uint32_t bus_id = 0; bus_id < list_of_bus_.size(); ++bus_id) {
+		try {
+			bus_infos.push_back(MakeBusInfo(bus_id, unique_stop_counter));
+		}
+		catch (const std::out_of_range&) {
+			bus_infos.push_back(std::nullopt);
+		}
+	}
+	bus_infos_ = std::move(bus_infos);
+}
+
+void TransportCatalogue::SetBusInfo(std::vector<std::optional<domain::BusInfo>> bus_infos)
+{
+	if (bus_infos.size() != list_of_bus_.size()) {
+		throw std::invalid_argument("Bus info doesn't match the catalogue");
+	}
+	bus_infos_ = std::move(bus_infos);
+}
+
+std::optional<domain::BusInfo> TransportCatalogue::GetComputedBusInfo(const uint32_t bus_id) const
+{
+	if (bus_id >= bus_infos_.size()) {
+		return std::nullopt;
+	}
+	return bus_infos_[bus_id];
+}
+
+std::vector<std::pair<const domain::Stop*, double>> TransportCatalogue::GetNearestStops(const geo::Coordinates point, const size_t count) const
+{
+	return MakeStopsByDistance(GetStopIndex().FindNearest(point, count));
+}
+
+std::vector<std::pair<const domain::Stop*, double>> TransportCatalogue::GetStopsWithinRadius(const geo::Coordinates point, const double radius) const
+{
+	return MakeStopsByDistance(GetStopIndex().FindWithinRadius(point, radius));
+}
+
+void TransportCatalogue::BuildStopIndex()
+{
+	stop_index_ = SpatialIndex(stop_coordinates_);
+}
+
+void TransportCatalogue::SetStopIndex(const std::vector<uint32_t>& order)
+{
+	stop_index_ = SpatialIndex(stop_coordinates_, order);
+}
+
+const SpatialIndex& TransportCatalogue::GetStopIndex() const
+{
+	if (stop_index_.GetSize() != stop_coordinates_.size()) {
+		throw std::logic_error("Stops were added after BuildStopIndex");
+	}
+	return stop_index_;
+}
+
+std::vector<std::pair<const domain::Stop*, double>> TransportCatalogue::MakeStopsByDistance(const SpatialIndex::Result& found) const
+{
+	std::vector<std::pair<const domain::Stop*, double>> stops;
+	stops.reserve(found.size());
+	for (const auto& [stop_id, distance] : found) {
+		stops.emplace_back(&list_of_stops_[stop_id], distance);
+	}
+	std::sort(stops.begin(), stops.end(), [](const auto& lhs, const auto& rhs) {
+		return lhs.second < rhs.second || (lhs.second == rhs.second && lhs.first->name < rhs.first->name);
+		});
+	return stops;
+}
+
+uint64_t TransportCatalogue::MakeDistanceKey(const uint32_t stop_from, const uint32_t stop_to)
+{
+	return (static_cast<uint64_t>(stop_from) << 32) | stop_to;
+}
+
+std::optional<unsigned int> TransportCatalogue::FindDistance(const uint32_t stop_from, const uint32_t stop_to) const
+{
+	const unsigned int* distance = map_distance_between_stops.Find(MakeDistanceKey(stop_from, stop_to));
+	if (!distance) {
+		return std::nullopt;
+	}
+	return *distance;
+}
+
 }//namespace transport_catalogue
 
 }//namecpace tc_project
\ No newline at end of file
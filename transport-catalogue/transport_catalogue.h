@@ -9,14 +9,32 @@
 #include <utility>
 #include <optional>
 #include <set>
+#include <cstdint>
 
 #include "geo.h"
 #include "domain.h"
+#include "flat_hash_map.h"
+#include "spatial_index.h"
 
 namespace tc_project{
 
 namespace transport_catalogue {
 
+// Число разных остановок маршрута за один проход без выделения памяти: остановка уже встречалась,
+// если её отметка равна номеру текущего прохода. Один счётчик - на один поток
+class UniqueStopCounter
+{
+public:
+	// epoch - номер последнего прохода; при переполнении номера отметки сбрасываются
+	explicit UniqueStopCounter(size_t stop_count, uint32_t epoch = 0);
+
+	size_t Count(const uint32_t* first, const uint32_t* last);
+
+private:
+	std::vector<uint32_t> stop_visit_epoch_;
+	uint32_t visit_epoch_;
+};
+
 class TransportCatalogue
 {
 public:
@@ -33,7 +51,10 @@ public:
 	std::optional<domain::BusInfo> GetBusInfo(std::string_view name) const;
 	std::optional <domain::StopInfo> GetStopInfo(std::string_view name) const;
 	std::optional<double> GetRoadDistance(std::string_view name) const;
-	std::optional< std::vector<domain::Bus*>> GetSortedAllBuses() const;
+	// автобусы и остановки по возрастанию имени; после добавления вне порядка нужен SortIndexes,
+	// иначе std::logic_error
+	const std::vector<domain::Bus*>& GetSortedAllBuses() const;
+	const std::vector<domain::Stop*>& GetSortedAllStops() const;
 	const std::unordered_map<std::string_view, domain::Bus*>& GetAllBuses() const;
 	const std::unordered_map<std::string_view, domain::Stop*>& GetAlltStops() const;
 	double GetStopsDistance(const std::pair<domain::Stop*, domain::Stop*>) const;
@@ -42,17 +63,71 @@ public:
 	bool BusExists(std::string_view name) const;
 	bool StopExists(std::string_view name) const;
 
+	// остановки и автобусы пронумерованы подряд с нуля в порядке добавления, см. domain::Stop::id
+	size_t GetStopCount() const;
+	size_t GetBusCount() const;
+	const domain::Stop& GetStop(uint32_t stop_id) const;
+	const domain::Bus& GetBus(uint32_t bus_id) const;
+	// номера автобусов, проходящих через остановку, по возрастанию имени
+	const std::vector<uint32_t>& GetBusesOnStop(uint32_t stop_id) const;
+
+	// сортирует автобусы и остановки по имени один раз после заполнения каталога
+	void SortIndexes();
+
+	// BusInfo всех автобусов считается один раз после заполнения каталога, запрос Bus только читает его;
+	// AddBus и AddDistanceFromTo сбрасывают посчитанное, и GetBusInfo снова считает на каждый запрос.
+	// Автобус, у которого на маршруте нет расстояния между соседними остановками, остаётся непосчитанным:
+	// ошибку получит только запрос Bus этого автобуса
+	void ComputeBusInfo();
+	// BusInfo, сохранённые в базе, по номерам автобусов; nullopt - не посчитан
+	void SetBusInfo(std::vector<std::optional<domain::BusInfo>> bus_infos);
+	// посчитанный BusInfo без подсчёта на месте; nullopt, если его нет
+	std::optional<domain::BusInfo> GetComputedBusInfo(uint32_t bus_id) const;
+
+	// остановки, ближайшие к точке, и остановки не дальше radius метров от неё;
+	// по возрастанию расстояния в метрах, затем имени
+	std::vector<std::pair<const domain::Stop*, double>> GetNearestStops(geo::Coordinates point, size_t count) const;
+	std::vector<std::pair<const domain::Stop*, double>> GetStopsWithinRadius(geo::Coordinates point, double radius) const;
+
+	// индекс координат строится один раз после заполнения каталога; если после этого добавлены остановки,
+	// поиск бросает std::logic_error до следующего BuildStopIndex
+	void BuildStopIndex();
+	// порядок индекса, сохранённый в базе, см. SpatialIndex::GetOrder; std::invalid_argument, если он повреждён
+	void SetStopIndex(const std::vector<uint32_t>& order);
+	const SpatialIndex& GetStopIndex() const;
+
 private:
 
+	domain::BusInfo MakeBusInfo(uint32_t bus_id, UniqueStopCounter& unique_stop_counter) const;
+
+	std::vector<std::pair<const domain::Stop*, double>> MakeStopsByDistance(const SpatialIndex::Result& found) const;
+
+	static uint64_t MakeDistanceKey(uint32_t stop_from, uint32_t stop_to);
+
+	std::optional<unsigned int> FindDistance(uint32_t stop_from, uint32_t stop_to) const;
+
 	std::deque<domain::Stop> list_of_stops_{};//остановок
 	std::unordered_map<std::string_view, domain::Stop*> map_of_stops_{};//доступ к остановке по имени за О(1)
 
 	std::deque<domain::Bus> list_of_bus_{};//маршруты
 	std::unordered_map<std::string_view, domain::Bus*> map_of_bus_{};//доступ к маршруту по имени за О(1)
 
-	std::unordered_map <domain::Stop*, std::set<domain::Bus*, domain::detail::BusCmp>> map_bus_on_stop_{};//автобусы на остановке
+	// данные для запросов хранятся массивами по номерам, имя ищется только при входе в каталог
+	std::vector<geo::Coordinates> stop_coordinates_{};//координаты остановки по её номеру
+	std::vector<std::vector<uint32_t>> buses_on_stop_{};//автобусы на остановке, по возрастанию имени
+	std::vector<uint32_t> route_offsets_{ 0 };//остановки автобуса b - route_stops_[route_offsets_[b], route_offsets_[b + 1])
+	std::vector<uint32_t> route_stops_{};//номера остановок маршрутов всех автобусов подряд
+	std::vector<std::vector<uint32_t>> distance_neighbours_{};//остановки, расстояние до которых от данной задано
+	std::vector<std::optional<domain::BusInfo>> bus_infos_{};//по номерам автобусов; пуст, пока не посчитан, см. ComputeBusInfo
+
+	std::vector<domain::Bus*> sorted_buses_{};
+	bool buses_sorted_ = true;
+	std::vector<domain::Stop*> sorted_stops_{};
+	bool stops_sorted_ = true;
+
+	SpatialIndex stop_index_{};//по номерам остановок; устарел, если размер не равен числу остановок
 
-	std::unordered_map<std::pair<domain::Stop*, domain::Stop*>, unsigned int, domain::detail::PairStopHasher> map_distance_between_stops{};//расстояния между остановками 
+	container::FlatHashMap<unsigned int> map_distance_between_stops{};//расстояния между остановками по паре номеров, см. MakeDistanceKey
 };
 
 }//namespace transport_catalogue
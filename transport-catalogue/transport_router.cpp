@@ -1,5 +1,8 @@
 #include "transport_router.h"
+#include <algorithm>
+#include <limits>
 #include <stdexcept>
+#include <tuple>
 
 namespace tc_project {
 
@@ -7,12 +10,49 @@ namespace transport_router {
 
 using namespace std::literals;
 
+RoutingMode ParseRoutingMode(std::string_view mode) {
+	if (mode == "all_pairs"sv) {
+		return RoutingMode::ALL_PAIRS;
+	}
+	if (mode == "dijkstra"sv) {
+		return RoutingMode::DIJKSTRA;
+	}
+	if (mode == "contraction_hierarchy"sv) {
+		return RoutingMode::CONTRACTION_HIERARCHY;
+	}
+	if (mode == "a_star"sv) {
+		return RoutingMode::A_STAR;
+	}
+	if (mode == "raptor"sv) {
+		return RoutingMode::RAPTOR;
+	}
+	if (mode == "lazy_all_pairs"sv) {
+		return RoutingMode::LAZY_ALL_PAIRS;
+	}
+	if (mode == "alt"sv) {
+		return RoutingMode::ALT;
+	}
+	if (mode == "bidirectional_dijkstra"sv) {
+		return RoutingMode::BIDIRECTIONAL_DIJKSTRA;
+	}
+	throw std::invalid_argument("Unknown routing mode: "s + std::string(mode));
+}
+
+GraphModel ParseGraphModel(std::string_view model) {
+	if (model == "complete"sv) {
+		return GraphModel::COMPLETE;
+	}
+	if (model == "linear"sv) {
+		return GraphModel::LINEAR;
+	}
+	throw std::invalid_argument("Unknown graph model: "s + std::string(model));
+}
 
 void TransportRouter::AddRouterSetting(RouterSettings settings) {
 	if (!CheckArgument(settings.bus_wait_time_) && !CheckArgument(settings.bus_velocity_)) {
 		throw std::invalid_argument("Incorrect wait time or velocity"s);
 	}
-	settings_ = { settings.bus_wait_time_, settings.bus_velocity_ };
+	settings_ = settings;
 }
 
 bool TransportRouter::CheckArgument(double arg) {
@@ -20,7 +60,7 @@ bool TransportRouter::CheckArgument(double arg) {
 }
 
 void TransportRouter::BuildGraph(graph::DirectedWeightedGraph<RouteWeight>& graph, const transport_catalogue::TransportCatalogue& catalogue_,
-	const std::vector<domain::Stop*>& stops, const std::string_view bus_name) {
+	const std::vector<domain::Stop*>& stops, uint32_t bus_id) {
 	for (int i = 0; i < stops.size() - 1; ++i) {
 		//           
 		double route_time = settings_.bus_wait_time_;
@@ -29,33 +69,329 @@ void TransportRouter::BuildGraph(graph::DirectedWeightedGraph<RouteWeight>& grap
 		for (int j = i + 1; j < stops.size(); ++j) {
 			const auto& stop_to = stops[j];
 			route_time += ComputeRouteTime(catalogue_, stops[j - 1], stop_to);
-			graph.AddEdge({ stopname_id_[stop_from->name], stopname_id_[stop_to->name], {bus_name, route_time, span_count++ } });
+			graph.AddEdge({ stopname_id_[stop_from->name], stopname_id_[stop_to->name], { bus_id, span_count++, route_time } });
+		}
+	}
+}
+
+void TransportRouter::BuildLinearGraph(graph::DirectedWeightedGraph<RouteWeight>& graph, const transport_catalogue::TransportCatalogue& catalogue_,
+	const std::vector<domain::Stop*>& stops, uint32_t bus_id, graph::VertexId first_ride_vertex) {
+	//    ,  -  ,  ;
+	//          
+	for (size_t i = 0; i < stops.size(); ++i) {
+		const graph::VertexId stop_vertex = stopname_id_.at(stops[i]->name);
+		const graph::VertexId ride_vertex = static_cast<graph::VertexId>(first_ride_vertex + i);
+		if (i + 1 < stops.size()) {
+			graph.AddEdge({ stop_vertex, ride_vertex, { bus_id, 0, settings_.bus_wait_time_ } });
+			graph.AddEdge({ ride_vertex, ride_vertex + 1, { bus_id, 1, ComputeRouteTime(catalogue_, stops[i], stops[i + 1]) } });
+		}
+		if (i > 0) {
+			graph.AddEdge({ ride_vertex, stop_vertex, { bus_id, 0, 0.0 } });
+		}
+	}
+}
+
+void TransportRouter::BuildBusGraph(graph::DirectedWeightedGraph<RouteWeight>& graph, const transport_catalogue::TransportCatalogue& catalogue_,
+	const domain::Bus& bus, graph::VertexId& ride_vertex) {
+	const uint32_t bus_id = GetBusId(bus.name);
+	auto add_trip = [&](const std::vector<domain::Stop*>& stops) {
+		if (settings_.graph_model_ == GraphModel::LINEAR) {
+			BuildLinearGraph(graph, catalogue_, stops, bus_id, ride_vertex);
+			ride_vertex += static_cast<graph::VertexId>(stops.size());
+		}
+		else {
+			BuildGraph(graph, catalogue_, stops, bus_id);
+		}
+	};
+
+	add_trip(bus.stop_on_route);
+	if (!bus.is_roundtrip) {
+		std::vector<domain::Stop*> rstops{ bus.stop_on_route.rbegin(), bus.stop_on_route.rend() };
+		add_trip(rstops);
+	}
+}
+
+size_t TransportRouter::CountRideVertices(const domain::Bus& bus) const {
+	if (settings_.graph_model_ != GraphModel::LINEAR) {
+		return 0;
+	}
+	return bus.stop_on_route.size() * (bus.is_roundtrip ? 1 : 2);
+}
+
+graph::VertexId TransportRouter::FindFreeRideVertices(size_t count) const {
+	const graph::VertexId vertex_count = static_cast<graph::VertexId>(graph_.GetVertexCount());
+	size_t run = 0;
+	for (graph::VertexId vertex = static_cast<graph::VertexId>(id_stopname_.size()); vertex < vertex_count; ++vertex) {
+		const auto outgoing = graph_.GetIncidentEdges(vertex);
+		const auto incoming = graph_.GetIncomingEdges(vertex);
+		run = outgoing.begin() == outgoing.end() && incoming.begin() == incoming.end() ? run + 1 : 0;
+		if (run == count) {
+			return static_cast<graph::VertexId>(vertex + 1 - count);
+		}
+	}
+	return vertex_count;
+}
+
+uint32_t TransportRouter::GetBusId(std::string_view bus_name) {
+	const auto [it, inserted] = busname_id_.emplace(bus_name, static_cast<uint32_t>(id_busname_.size()));
+	if (inserted) {
+		id_busname_.push_back(bus_name);
+	}
+	return it->second;
+}
+
+void TransportRouter::AddBus(const transport_catalogue::TransportCatalogue& catalogue, const domain::Bus& bus) {
+	for (const domain::Stop* stop : bus.stop_on_route) {
+		if (!stopname_id_.count(stop->name)) {
+			throw std::invalid_argument("Stop "s + stop->name + " isn't in the routing graph"s);
+		}
+	}
+	//          
+	if (const auto it = busname_id_.find(bus.name); it != busname_id_.end()) {
+		const uint32_t bus_id = it->second;
+		if (std::any_of(graph_.GetEdges().begin(), graph_.GetEdges().end(),
+			[bus_id](const graph::Edge<RouteWeight>& edge) { return edge.weight.bus_id == bus_id; })) {
+			throw std::invalid_argument("Bus "s + bus.name + " is already in the routing graph, remove it first"s);
 		}
 	}
+
+	const size_t edge_count = graph_.GetEdgeCount();
+	const size_t ride_vertex_count = CountRideVertices(bus);
+	graph::VertexId ride_vertex = ride_vertex_count > 0 ? FindFreeRideVertices(ride_vertex_count) : graph_.GetVertexCount();
+	//       ,      
+	const bool vertex_count_changed = ride_vertex_count > 0 && ride_vertex == graph_.GetVertexCount();
+	if (vertex_count_changed) {
+		graph_.AddVertices(ride_vertex_count);
+	}
+	BuildBusGraph(graph_, catalogue, bus, ride_vertex);
+
+	const std::vector<graph::EdgeId> new_edge_ids = graph_.Finalize();
+	const std::vector<graph::EdgeId> added_edges(new_edge_ids.begin() + edge_count, new_edge_ids.end());
+	UpdateRouter(new_edge_ids, added_edges, vertex_count_changed);
+
+	if (raptor_router_) {
+		raptor_router_->AddTrips(MakeRaptorTrips(catalogue, bus));
+	}
+}
+
+void TransportRouter::RemoveBus(std::string_view bus_name) {
+	const auto it = busname_id_.find(bus_name);
+	if (it == busname_id_.end()) {
+		return;
+	}
+	//    ,  ,  ,   
+	const uint32_t bus_id = it->second;
+
+	const size_t edge_count = graph_.GetEdgeCount();
+	const std::vector<graph::EdgeId> new_edge_ids = graph_.EraseEdges([bus_id](const graph::Edge<RouteWeight>& edge) {
+		return edge.weight.bus_id == bus_id;
+	});
+	if (graph_.GetEdgeCount() != edge_count) {
+		UpdateRouter(new_edge_ids, {}, false);
+	}
+
+	if (raptor_router_) {
+		raptor_router_->RemoveBus(bus_id);
+	}
+}
+
+void TransportRouter::UpdateRouter(const std::vector<graph::EdgeId>& new_edge_ids, const std::vector<graph::EdgeId>& added_edges,
+	bool vertex_count_changed) {
+	//    A*   ,     
+	//       . RAPTOR      
+	if (settings_.routing_mode_ == RoutingMode::RAPTOR) {
+		return;
+	}
+	if (settings_.routing_mode_ == RoutingMode::ALL_PAIRS && router_ && !vertex_count_changed) {
+		router_->UpdateRoutes(new_edge_ids, added_edges);
+		return;
+	}
+	router_.reset();
+	dijkstra_router_.reset();
+	lazy_router_.reset();
+	landmarks_.reset();
+	ch_router_.reset();
+	InicializeRouter();
 }
 
 void TransportRouter::InicializeGraph(const transport_catalogue::TransportCatalogue& catalogue) {
-	graph::DirectedWeightedGraph<RouteWeight> graph(CountStops(catalogue));
-	for (const auto& [bus_name, route] : catalogue.GetAllBuses()) {
-		BuildGraph(graph, catalogue, route->stop_on_route, bus_name);
-		if (!route->is_roundtrip) {
-			std::vector<domain::Stop*> rstops{ route->stop_on_route.rbegin(), route->stop_on_route.rend() };
-			BuildGraph(graph, catalogue, rstops, bus_name);
+	//       ,  ,   make_base
+	//   process_requests,          
+	const size_t stop_count = CountStops(catalogue);
+	const auto& buses = catalogue.GetSortedAllBuses();
+	busname_id_.clear();
+	id_busname_.clear();
+
+	size_t vertex_count = stop_count;
+	for (const domain::Bus* route : buses) {
+		vertex_count += CountRideVertices(*route);
+	}
+
+	graph::DirectedWeightedGraph<RouteWeight> graph(vertex_count);
+	graph::VertexId ride_vertex = static_cast<graph::VertexId>(stop_count);
+	for (const domain::Bus* route : buses) {
+		BuildBusGraph(graph, catalogue, *route, ride_vertex);
+	}
+	graph.Finalize();
+	graph_ = std::move(graph);
+	source_catalogue_ = &catalogue;
+
+	InicializeRouter();
+}
+
+void TransportRouter::InicializeGraph(const transport_catalogue::TransportCatalogue& catalogue, graph::DirectedWeightedGraph<RouteWeight> graph,
+	std::vector<std::string_view> bus_names) {
+	const size_t stop_count = CountStops(catalogue);
+	const bool linear = settings_.graph_model_ == GraphModel::LINEAR;
+	if (linear ? graph.GetVertexCount() < stop_count : graph.GetVertexCount() != stop_count) {
+		throw std::invalid_argument("Graph doesn't match the catalogue"s);
+	}
+	for (const auto& edge : graph.GetEdges()) {
+		if (edge.weight.bus_id >= bus_names.size()) {
+			throw std::invalid_argument("Graph doesn't match the catalogue"s);
 		}
 	}
+	busname_id_.clear();
+	id_busname_ = std::move(bus_names);
+	for (uint32_t bus_id = 0; bus_id < id_busname_.size(); ++bus_id) {
+		busname_id_.emplace(id_busname_[bus_id], bus_id);
+	}
+	graph.Finalize();
 	graph_ = std::move(graph);
-	router_ = std::make_unique<graph::Router<RouteWeight>>(graph::Router(graph_));
+	source_catalogue_ = &catalogue;
+}
+
+void TransportRouter::InicializeRouter() {
+	switch (settings_.routing_mode_) {
+	case RoutingMode::ALL_PAIRS:
+		router_ = std::make_unique<graph::Router<RouteWeight>>(graph_, true, settings_.thread_count_);
+		break;
+	case RoutingMode::DIJKSTRA:
+	case RoutingMode::BIDIRECTIONAL_DIJKSTRA:
+		dijkstra_router_ = std::make_unique<graph::DijkstraRouter<RouteWeight>>(graph_);
+		break;
+	case RoutingMode::CONTRACTION_HIERARCHY:
+		//      .     
+		//       ,     
+		if (!ch_router_) {
+			ch_router_ = std::make_unique<graph::ContractionHierarchy<RouteWeight>>(graph_);
+		}
+		dijkstra_router_ = std::make_unique<graph::DijkstraRouter<RouteWeight>>(graph_);
+		break;
+	case RoutingMode::LAZY_ALL_PAIRS:
+		lazy_router_ = std::make_unique<graph::LazyRouter<RouteWeight>>(graph_, settings_.lazy_row_budget_);
+		break;
+	case RoutingMode::ALT:
+		dijkstra_router_ = std::make_unique<graph::DijkstraRouter<RouteWeight>>(graph_);
+		//      
+		if (!landmarks_) {
+			landmarks_ = std::make_unique<graph::Landmarks<RouteWeight>>(graph_, settings_.landmark_count_);
+		}
+		break;
+	case RoutingMode::A_STAR:
+		dijkstra_router_ = std::make_unique<graph::DijkstraRouter<RouteWeight>>(graph_);
+		FillVertexCoordinates();
+		astar_time_per_meter_ = ComputeAStarTimePerMeter();
+		break;
+	case RoutingMode::RAPTOR:
+	{
+		std::vector<RaptorRouter::Trip> trips;
+		for (const domain::Bus* route : source_catalogue_->GetSortedAllBuses()) {
+			auto bus_trips = MakeRaptorTrips(*source_catalogue_, *route);
+			std::move(bus_trips.begin(), bus_trips.end(), std::back_inserter(trips));
+		}
+		raptor_router_ = std::make_unique<RaptorRouter>(id_stopname_.size(), settings_.bus_wait_time_, std::move(trips));
+		break;
+	}
+	}
+}
+
+std::vector<RaptorRouter::Trip> TransportRouter::MakeRaptorTrips(const transport_catalogue::TransportCatalogue& catalogue_, const domain::Bus& bus) {
+	auto make_trip = [&](const std::vector<domain::Stop*>& stops) {
+		RaptorRouter::Trip trip{ GetBusId(bus.name), {}, {} };
+		trip.stops.reserve(stops.size());
+		for (size_t i = 0; i < stops.size(); ++i) {
+			trip.stops.push_back(stopname_id_.at(stops[i]->name));
+			if (i > 0) {
+				trip.ride_times.push_back(ComputeRouteTime(catalogue_, stops[i - 1], stops[i]));
+			}
+		}
+		return trip;
+	};
+
+	std::vector<RaptorRouter::Trip> trips;
+	trips.push_back(make_trip(bus.stop_on_route));
+	if (!bus.is_roundtrip) {
+		trips.push_back(make_trip({ bus.stop_on_route.rbegin(), bus.stop_on_route.rend() }));
+	}
+	return trips;
 }
 
+double TransportRouter::ComputeAStarTimePerMeter() const {
+	//           ,
+	//  1 / bus_velocity_     ;     .
+	//          ,       
+	double time_per_meter = std::numeric_limits<double>::infinity();
+	for (const auto& edge : graph_.GetEdges()) {
+		const double distance = geo::ComputeDistance(vertex_coordinates_[edge.from], vertex_coordinates_[edge.to]);
+		if (distance > 0) {
+			const double ride_time = edge.weight.total_time - (IsStopVertex(edge.from) ? settings_.bus_wait_time_ : 0.0);
+			time_per_meter = std::min(time_per_meter, ride_time / distance);
+		}
+	}
+	if (time_per_meter == std::numeric_limits<double>::infinity()) {
+		return 0.0;
+	}
+	//    ,      
+	return std::max(0.0, time_per_meter * (1.0 - 1e-9));
+}
+
+double TransportRouter::ComputeAStarPotential(graph::VertexId vertex, graph::VertexId to) const {
+	if (vertex == to) {
+		return 0.0;
+	}
+	//          ,    - 
+	return (IsStopVertex(vertex) ? settings_.bus_wait_time_ : 0.0) + astar_time_per_meter_ * geo::ComputeDistance(vertex_coordinates_[vertex], vertex_coordinates_[to]);
+}
+
+
+bool TransportRouter::IsStopVertex(graph::VertexId vertex) const {
+	return vertex < id_stopname_.size();
+}
+
+void TransportRouter::FillVertexCoordinates() {
+	//     ,  ,      
+	vertex_coordinates_.resize(graph_.GetVertexCount());
+	for (const auto& edge : graph_.GetEdges()) {
+		if (IsStopVertex(edge.from) && !IsStopVertex(edge.to)) {
+			vertex_coordinates_[edge.to] = vertex_coordinates_[edge.from];
+		}
+		else if (!IsStopVertex(edge.from) && IsStopVertex(edge.to)) {
+			vertex_coordinates_[edge.from] = vertex_coordinates_[edge.to];
+		}
+	}
+}
 
 size_t TransportRouter::CountStops(const transport_catalogue::TransportCatalogue& catalogue_) {
 	size_t stops_counter = 0;
-	const auto& stops = catalogue_.GetAlltStops();
+	std::vector<std::string_view> stops;
+	stops.reserve(catalogue_.GetAlltStops().size());
+	for (const auto& stop : catalogue_.GetAlltStops()) {
+		stops.push_back(stop.first);
+	}
+	std::sort(stops.begin(), stops.end());
+
+	//   :       
+	stopname_id_.clear();
+	id_stopname_.clear();
 	stopname_id_.reserve(stops.size());
 	id_stopname_.reserve(stops.size());
-	for (const auto& stop : stops) {
-		stopname_id_.insert({ stop.first, stops_counter });
-		id_stopname_.insert({ stops_counter++, stop.first });
+	vertex_coordinates_.clear();
+	vertex_coordinates_.reserve(stops.size());
+	for (const std::string_view stop : stops) {
+		stopname_id_.insert({ stop, stops_counter });
+		id_stopname_.insert({ stops_counter++, stop });
+		vertex_coordinates_.push_back(catalogue_.FindStop(stop)->coordinates);
 	}
 	return stops_counter;
 }
@@ -81,10 +417,166 @@ RouteWeight operator+(const RouteWeight& left, const RouteWeight& right) {
 }
 
 std::optional <graph::Router<RouteWeight>::RouteInfo> TransportRouter::BuildRouter(const std::string_view stop_name_from, const std::string_view stop_name_to) const {
-	if (!router_) {
+	if (router_) {
+		return router_->BuildRoute(stopname_id_.at(stop_name_from), stopname_id_.at(stop_name_to));
+	}
+	if (lazy_router_) {
+		return lazy_router_->BuildRoute(stopname_id_.at(stop_name_from), stopname_id_.at(stop_name_to));
+	}
+	if (ch_router_) {
+		return ch_router_->BuildRoute(stopname_id_.at(stop_name_from), stopname_id_.at(stop_name_to));
+	}
+	if (dijkstra_router_ && settings_.routing_mode_ == RoutingMode::A_STAR) {
+		const graph::VertexId to = stopname_id_.at(stop_name_to);
+		return dijkstra_router_->BuildRoute(stopname_id_.at(stop_name_from), to,
+			[this, to](graph::VertexId vertex) { return RouteWeight{ 0, 0, ComputeAStarPotential(vertex, to) }; });
+	}
+	if (dijkstra_router_ && settings_.routing_mode_ == RoutingMode::BIDIRECTIONAL_DIJKSTRA) {
+		return dijkstra_router_->BuildRouteBidirectional(stopname_id_.at(stop_name_from), stopname_id_.at(stop_name_to));
+	}
+	if (dijkstra_router_ && landmarks_) {
+		const graph::VertexId to = stopname_id_.at(stop_name_to);
+		return dijkstra_router_->BuildRoute(stopname_id_.at(stop_name_from), to,
+			[this, to](graph::VertexId vertex) { return landmarks_->GetLowerBound(vertex, to); });
+	}
+	if (dijkstra_router_) {
+		return dijkstra_router_->BuildRoute(stopname_id_.at(stop_name_from), stopname_id_.at(stop_name_to));
+	}
+	return std::nullopt;
+}
+
+std::optional<Journey> TransportRouter::BuildJourney(const std::string_view stop_name_from, const std::string_view stop_name_to) const {
+	if (raptor_router_) {
+		const auto raptor_journey = raptor_router_->BuildRoute(stopname_id_.at(stop_name_from), stopname_id_.at(stop_name_to));
+		if (!raptor_journey) {
+			return std::nullopt;
+		}
+		Journey journey{ raptor_journey->total_time, {} };
+		journey.legs.reserve(raptor_journey->legs.size());
+		for (const auto& leg : raptor_journey->legs) {
+			journey.legs.push_back({ leg.from_stop, leg.bus_id, leg.span_count, leg.total_time - settings_.bus_wait_time_ });
+		}
+		return journey;
+	}
+
+	const auto route = BuildRouter(stop_name_from, stop_name_to);
+	if (!route) {
 		return std::nullopt;
 	}
-	return router_->BuildRoute(stopname_id_.at(stop_name_from), stopname_id_.at(stop_name_to));
+	return Journey{ route->weight.total_time, GetRouteLegs(*route) };
+}
+
+std::vector<std::optional<double>> TransportRouter::BuildRouteTimes(const std::string_view stop_name_from,
+	const std::vector<std::string_view>& stop_names_to) const {
+	const graph::VertexId from = stopname_id_.at(stop_name_from);
+	std::vector<graph::VertexId> to;
+	to.reserve(stop_names_to.size());
+	for (const std::string_view stop_name : stop_names_to) {
+		to.push_back(stopname_id_.at(stop_name));
+	}
+
+	std::vector<std::optional<double>> times;
+	times.reserve(to.size());
+	auto add_time = [&times](const auto& weight) {
+		times.push_back(weight ? std::optional<double>(weight->total_time) : std::nullopt);
+	};
+
+	if (router_) {
+		for (const graph::VertexId vertex : to) {
+			add_time(router_->GetRouteWeight(from, vertex));
+		}
+	}
+	else if (lazy_router_) {
+		//  from   ,     
+		for (const graph::VertexId vertex : to) {
+			add_time(lazy_router_->GetRouteWeight(from, vertex));
+		}
+	}
+	else if (raptor_router_) {
+		//          
+		const auto all_times = raptor_router_->BuildRouteTimes(from);
+		for (const graph::VertexId vertex : to) {
+			times.push_back(all_times[vertex]);
+		}
+	}
+	else if (dijkstra_router_) {
+		//     from   ,      :
+		//           
+		for (const auto& weight : dijkstra_router_->BuildRouteWeights(from, to)) {
+			add_time(weight);
+		}
+	}
+	else {
+		times.assign(to.size(), std::nullopt);
+	}
+	return times;
+}
+
+std::vector<std::pair<std::string_view, double>> TransportRouter::BuildReachableStops(const std::string_view stop_name_from, double max_time) const {
+	const graph::VertexId from = stopname_id_.at(stop_name_from);
+	std::vector<std::pair<std::string_view, double>> stops;
+
+	if (router_ || lazy_router_) {
+		//        ,   
+		for (graph::VertexId vertex = 0; vertex < id_stopname_.size(); ++vertex) {
+			const auto weight = router_ ? router_->GetRouteWeight(from, vertex) : lazy_router_->GetRouteWeight(from, vertex);
+			if (weight && weight->total_time <= max_time) {
+				stops.emplace_back(GetStopNameFromID(vertex), weight->total_time);
+			}
+		}
+	}
+	else if (raptor_router_) {
+		const auto times = raptor_router_->BuildRouteTimes(from);
+		for (graph::VertexId vertex = 0; vertex < times.size(); ++vertex) {
+			if (times[vertex] && *times[vertex] <= max_time) {
+				stops.emplace_back(GetStopNameFromID(vertex), *times[vertex]);
+			}
+		}
+	}
+	else if (dijkstra_router_) {
+		//   ,   ;        
+		const RouteWeight max_weight{ 0, 0, max_time };
+		for (const auto& [vertex, weight] : dijkstra_router_->BuildRouteWeightsWithin(from, max_weight)) {
+			if (IsStopVertex(vertex)) {
+				stops.emplace_back(GetStopNameFromID(vertex), weight.total_time);
+			}
+		}
+	}
+
+	std::sort(stops.begin(), stops.end(), [](const auto& lhs, const auto& rhs) {
+		return std::tie(lhs.second, lhs.first) < std::tie(rhs.second, rhs.first);
+	});
+	return stops;
+}
+
+std::vector<RouteLeg> TransportRouter::GetRouteLegs(const graph::Router<RouteWeight>::RouteInfo& route) const {
+	std::vector<RouteLeg> legs;
+	if (settings_.graph_model_ == GraphModel::COMPLETE) {
+		legs.reserve(route.edges.size());
+		for (const graph::EdgeId edge_id : route.edges) {
+			const auto& edge = graph_.GetEdge(edge_id);
+			legs.push_back({ edge.from, edge.weight.bus_id, edge.weight.span_count,
+				edge.weight.total_time - settings_.bus_wait_time_ });
+		}
+		return legs;
+	}
+
+	//   ,   ,  .
+	//      ,   BuildGraph,      COMPLETE
+	double leg_time = 0.0;
+	for (const graph::EdgeId edge_id : route.edges) {
+		const auto& edge = graph_.GetEdge(edge_id);
+		if (IsStopVertex(edge.from)) {
+			legs.push_back({ edge.from, edge.weight.bus_id, 0, 0.0 });
+			leg_time = edge.weight.total_time;
+		}
+		else if (!IsStopVertex(edge.to)) {
+			leg_time += edge.weight.total_time;
+			legs.back().span_count += edge.weight.span_count;
+			legs.back().ride_time = leg_time - settings_.bus_wait_time_;
+		}
+	}
+	return legs;
 }
 
 graph::DirectedWeightedGraph<RouteWeight>& TransportRouter::GetGraph() {
@@ -103,6 +595,30 @@ const std::unique_ptr<graph::Router<RouteWeight>>& TransportRouter::GetRouter()
 	return router_;
 }
 
+const std::unique_ptr<graph::LazyRouter<RouteWeight>>& TransportRouter::GetLazyRouter() const {
+	return lazy_router_;
+}
+
+std::unique_ptr<graph::Landmarks<RouteWeight>>& TransportRouter::GetLandmarks() {
+	return landmarks_;
+}
+
+const std::unique_ptr<graph::Landmarks<RouteWeight>>& TransportRouter::GetLandmarks() const {
+	return landmarks_;
+}
+
+std::unique_ptr<graph::ContractionHierarchy<RouteWeight>>& TransportRouter::GetContractionHierarchy() {
+	return ch_router_;
+}
+
+const std::unique_ptr<graph::ContractionHierarchy<RouteWeight>>& TransportRouter::GetContractionHierarchy() const {
+	return ch_router_;
+}
+
+std::unique_ptr<MappedFile>& TransportRouter::GetRoutingTableFile() {
+	return routing_table_file_;
+}
+
 const RouterSettings& TransportRouter::GetRouterSettings() const {
 	return settings_;
 }
@@ -111,6 +627,14 @@ const std::string_view TransportRouter::GetStopNameFromID(size_t id) const {
 	return id_stopname_.at(id);
 }
 
+const std::string_view TransportRouter::GetBusNameFromID(uint32_t id) const {
+	return id_busname_.at(id);
+}
+
+const std::vector<std::string_view>& TransportRouter::GetBusNames() const {
+	return id_busname_;
+}
+
 
 RouterSettings& TransportRouter::GetRouterSettings()
 {
@@ -1,6 +1,12 @@
 #pragma once
 #include "transport_catalogue.h"
 #include "router.h"
+#include "dijkstra_router.h"
+#include "lazy_router.h"
+#include "landmarks.h"
+#include "contraction_hierarchy.h"
+#include "mapped_file.h"
+#include "raptor_router.h"
 
 #include <memory>
 
@@ -9,22 +15,97 @@ namespace tc_project {
 namespace transport_router {
 
 constexpr static double KM_TO_MIN_FACTOR = 1000.0 / 60.0;
+constexpr static size_t DEFAULT_LAZY_ROW_BUDGET = 1024;
+constexpr static size_t DEFAULT_LANDMARK_COUNT = 8;
 
+// имя автобуса хранится в TransportRouter, в ребре только его номер, см. GetBusNameFromID
 struct RouteWeight {
-	std::string_view bus_name{};
-	double total_time = 0;
+	uint32_t bus_id = 0;
 	int span_count = 0;
+	double total_time = 0;
+};
+
+}//transport_router
+
+}//namespace tc_project
+
+namespace graph {
+
+// в таблице всех пар хранится только время: operator+ отбрасывает автобус и число остановок
+template <>
+struct WeightTraits<tc_project::transport_router::RouteWeight> {
+	using Scalar = double;
+
+	static Scalar ToScalar(const tc_project::transport_router::RouteWeight& weight) {
+		return weight.total_time;
+	}
+
+	static tc_project::transport_router::RouteWeight FromScalar(Scalar scalar) {
+		return { 0, 0, scalar };
+	}
+};
+
+}//namespace graph
+
+namespace tc_project {
+
+namespace transport_router {
+
+enum class RoutingMode {
+	ALL_PAIRS,// предподсчёт всех пар в graph::Router
+	DIJKSTRA,// поиск Дейкстры на каждый запрос
+	CONTRACTION_HIERARCHY,// иерархия сжатия, строится в make_base
+	A_STAR,// A* с оценкой по расстоянию по прямой до конечной остановки
+	RAPTOR,// поиск по раундам прямо по рейсам автобусов, без графа
+	LAZY_ALL_PAIRS,// строки таблицы всех пар по первому запросу, не больше lazy_row_budget_ строк
+	ALT,// A* с оценкой по ориентирам, таблицы ориентиров строятся в make_base
+	BIDIRECTIONAL_DIJKSTRA// поиск Дейкстры навстречу из from и из to
+};
+
+RoutingMode ParseRoutingMode(std::string_view mode);
+
+enum class GraphModel {
+	COMPLETE,// ребро от каждой остановки маршрута до каждой следующей, O(L^2) рёбер на маршрут
+	LINEAR// вершины ожидания и поездки: посадка, перегоны и высадка, O(L) рёбер на маршрут
 };
 
+GraphModel ParseGraphModel(std::string_view model);
+
 struct RouterSettings {
 	RouterSettings() = default;
 
-	RouterSettings(double bus_wait_time, double bus_velocity)
+	RouterSettings(double bus_wait_time, double bus_velocity, RoutingMode routing_mode = RoutingMode::ALL_PAIRS, size_t thread_count = 1,
+		GraphModel graph_model = GraphModel::COMPLETE, size_t lazy_row_budget = DEFAULT_LAZY_ROW_BUDGET,
+		size_t landmark_count = DEFAULT_LANDMARK_COUNT)
 		: bus_wait_time_(bus_wait_time)
-		, bus_velocity_(bus_velocity) {};
+		, bus_velocity_(bus_velocity)
+		, routing_mode_(routing_mode)
+		, thread_count_(thread_count)
+		, graph_model_(graph_model)
+		, lazy_row_budget_(lazy_row_budget)
+		, landmark_count_(landmark_count) {};
 
 	double bus_wait_time_ = 0.0;
 	double bus_velocity_ = 0.0;
+	RoutingMode routing_mode_ = RoutingMode::ALL_PAIRS;
+	size_t thread_count_ = 1;// потоков для предподсчёта всех пар
+	GraphModel graph_model_ = GraphModel::COMPLETE;
+	size_t lazy_row_budget_ = DEFAULT_LAZY_ROW_BUDGET;// строк в памяти для LAZY_ALL_PAIRS
+	size_t landmark_count_ = DEFAULT_LANDMARK_COUNT;// ориентиров для ALT
+};
+
+// ожидание на остановке и поездка на одном автобусе: элементы Wait и Bus ответа;
+// имена - GetStopNameFromID и GetBusNameFromID, их ищут только при выводе ответа
+struct RouteLeg {
+	graph::VertexId stop_id = 0;
+	uint32_t bus_id = 0;
+	int span_count = 0;
+	double ride_time = 0.0;
+};
+
+struct Journey {
+	double total_time = 0.0;
+	std::vector<RouteLeg> legs;
 };
 
 class TransportRouter {
@@ -33,6 +114,14 @@ public:
 	TransportRouter() = default;
 
 	std::optional <graph::Router<RouteWeight>::RouteInfo> BuildRouter(const std::string_view stop_name_from, const std::string_view stop_name_to) const;
+	// маршрут для ответа на запрос Route в любом режиме, включая RAPTOR
+	std::optional<Journey> BuildJourney(const std::string_view stop_name_from, const std::string_view stop_name_to) const;
+	// время в пути от from до каждой из to без восстановления маршрутов; nullopt - маршрута нет
+	std::vector<std::optional<double>> BuildRouteTimes(const std::string_view stop_name_from, const std::vector<std::string_view>& stop_names_to) const;
+	// остановки, до которых можно доехать из from не дольше max_time, по возрастанию времени, затем имени
+	std::vector<std::pair<std::string_view, double>> BuildReachableStops(const std::string_view stop_name_from, double max_time) const;
+	// участки найденного маршрута, одинаковые для всех моделей графа
+	std::vector<RouteLeg> GetRouteLegs(const graph::Router<RouteWeight>::RouteInfo& route) const;
 
 	graph::DirectedWeightedGraph<RouteWeight>& GetGraph();
 	const graph::DirectedWeightedGraph<RouteWeight>& GetGraph() const;
@@ -40,12 +129,41 @@ public:
 	std::unique_ptr<graph::Router<RouteWeight>>& GetRouter();
 	const std::unique_ptr<graph::Router<RouteWeight>>& GetRouter() const;
 
+	const std::unique_ptr<graph::LazyRouter<RouteWeight>>& GetLazyRouter() const;
+
+	std::unique_ptr<graph::Landmarks<RouteWeight>>& GetLandmarks();
+	const std::unique_ptr<graph::Landmarks<RouteWeight>>& GetLandmarks() const;
+
+	std::unique_ptr<graph::ContractionHierarchy<RouteWeight>>& GetContractionHierarchy();
+	const std::unique_ptr<graph::ContractionHierarchy<RouteWeight>>& GetContractionHierarchy() const;
+
+	// файл таблицы маршрутов, на память которого может ссылаться router_
+	std::unique_ptr<MappedFile>& GetRoutingTableFile();
+
 	const RouterSettings& GetRouterSettings() const;
 	const std::string_view GetStopNameFromID(size_t id) const;
+	const std::string_view GetBusNameFromID(uint32_t id) const;
+	// имена автобусов по номерам из RouteWeight::bus_id
+	const std::vector<std::string_view>& GetBusNames() const;
 
 	void AddRouterSetting(RouterSettings settings);
 
 	void InicializeGraph(const transport_catalogue::TransportCatalogue& catalogue_);
+	// граф, загруженный из базы: вершины должны быть пронумерованы так же, как в InicializeGraph,
+	// bus_names[bus_id] - имена автобусов рёбер, ссылающиеся на каталог
+	void InicializeGraph(const transport_catalogue::TransportCatalogue& catalogue_, graph::DirectedWeightedGraph<RouteWeight> graph,
+		std::vector<std::string_view> bus_names);
+	// строит маршрутизатор выбранного режима над текущим графом
+	void InicializeRouter();
+
+	// Рёбра одного автобуса без перестройки всего графа. Таблица всех пар исправляется только там,
+	// где изменились пути; иерархия сжатия строится заново. Изменение автобуса - RemoveBus и AddBus.
+	// Автобус уже должен быть в каталоге, а его остановки - в графе; если рёбра автобуса
+	// уже есть в графе - std::invalid_argument
+	void AddBus(const transport_catalogue::TransportCatalogue& catalogue, const domain::Bus& bus);
+	// вершины поездки удалённого автобуса в модели LINEAR остаются в графе без рёбер,
+	// AddBus занимает их снова, и число вершин не меняется, если новому автобусу их хватает
+	void RemoveBus(std::string_view bus_name);
 
 	RouterSettings& GetRouterSettings();
 
@@ -53,12 +171,35 @@ private:
 
 	RouterSettings settings_{};
 
-	std::unordered_map<std::string_view, size_t> stopname_id_;
+	std::unordered_map<std::string_view, graph::VertexId> stopname_id_;
 
 	std::unordered_map<uint32_t, std::string_view> id_stopname_;
 
+	std::unordered_map<std::string_view, uint32_t> busname_id_;
+
+	std::vector<std::string_view> id_busname_;
+
+	std::vector<geo::Coordinates> vertex_coordinates_;// координаты остановок вершин, для A*
+
+	double astar_time_per_meter_ = 0.0;// минут на метр расстояния по прямой, не больше чем на любом ребре графа
+
+	std::unique_ptr<MappedFile> routing_table_file_ = nullptr;
+
 	std::unique_ptr<graph::Router<RouteWeight>> router_ = nullptr;
 
+	std::unique_ptr<graph::DijkstraRouter<RouteWeight>> dijkstra_router_ = nullptr;
+
+	std::unique_ptr<graph::LazyRouter<RouteWeight>> lazy_router_ = nullptr;
+
+	std::unique_ptr<graph::Landmarks<RouteWeight>> landmarks_ = nullptr;
+
+	std::unique_ptr<graph::ContractionHierarchy<RouteWeight>> ch_router_ = nullptr;
+
+	std::unique_ptr<RaptorRouter> raptor_router_ = nullptr;
+
+	// каталог, по которому построен граф; нужен RAPTOR, который строится по рейсам, а не по графу
+	const transport_catalogue::TransportCatalogue* source_catalogue_ = nullptr;
+
 	graph::DirectedWeightedGraph<RouteWeight> graph_;
 
 	bool CheckArgument(double arg);
@@ -66,9 +207,41 @@ private:
 	double ComputeRouteTime(const transport_catalogue::TransportCatalogue& catalogue_, domain::Stop* stop_from_index, domain::Stop* stop_to_index);
 
 	void BuildGraph(graph::DirectedWeightedGraph<RouteWeight>& graph, const transport_catalogue::TransportCatalogue& catalogue_,
-		const std::vector<domain::Stop*>& stops, const std::string_view bus_name);
+		const std::vector<domain::Stop*>& stops, uint32_t bus_id);
+
+	// рёбра обоих направлений автобуса; ride_vertex - первая свободная вершина поездки модели LINEAR
+	void BuildBusGraph(graph::DirectedWeightedGraph<RouteWeight>& graph, const transport_catalogue::TransportCatalogue& catalogue_,
+		const domain::Bus& bus, graph::VertexId& ride_vertex);
+
+	size_t CountRideVertices(const domain::Bus& bus) const;
+
+	// первая из count подряд идущих вершин поездки без рёбер, оставшихся от удалённых автобусов;
+	// если таких нет - число вершин графа, то есть новые вершины добавляются в конец
+	graph::VertexId FindFreeRideVertices(size_t count) const;
+
+	// номер автобуса для рёбер; новому имени выдаётся следующий номер
+	uint32_t GetBusId(std::string_view bus_name);
+
+	// рейсы автобуса в обоих направлениях с тем же временем перегонов, что и в графе
+	std::vector<RaptorRouter::Trip> MakeRaptorTrips(const transport_catalogue::TransportCatalogue& catalogue_, const domain::Bus& bus);
+
+	// маршрутизатор после изменения рёбер графа, см. graph::Router::UpdateRoutes
+	void UpdateRouter(const std::vector<graph::EdgeId>& new_edge_ids, const std::vector<graph::EdgeId>& added_edges, bool vertex_count_changed);
+
+	// вершины поездки рейса занимают номера [first_ride_vertex, first_ride_vertex + stops.size())
+	void BuildLinearGraph(graph::DirectedWeightedGraph<RouteWeight>& graph, const transport_catalogue::TransportCatalogue& catalogue_,
+		const std::vector<domain::Stop*>& stops, uint32_t bus_id, graph::VertexId first_ride_vertex);
+
+	// вершины с номерами меньше числа остановок - остановки (в модели LINEAR - вершины ожидания)
+	bool IsStopVertex(graph::VertexId vertex) const;
+
+	void FillVertexCoordinates();
 
 	size_t CountStops(const transport_catalogue::TransportCatalogue& catalogue_);
+
+	double ComputeAStarTimePerMeter() const;
+
+	double ComputeAStarPotential(graph::VertexId vertex, graph::VertexId to) const;
 };
 
 bool operator<(const RouteWeight& left, const RouteWeight& right);
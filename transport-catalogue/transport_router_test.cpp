@@ -0,0 +1,180 @@
+#include "json.h"
+#include "json_reader.h"
+#include "transport_catalogue.h"
+#include "transport_router.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Проверка TransportRouter::RemoveBus и AddBus: после удаления автобуса время в пути между
+// любыми остановками должно совпасть с маршрутизатором, построенным без этого автобуса,
+// а после возврата автобуса - с построенным по полной базе
+
+using namespace tc_project;
+using namespace std::literals;
+
+namespace {
+
+constexpr size_t STOP_COUNT = 12;
+
+struct BusDescription {
+	std::string name;
+	std::vector<size_t> stops;
+	bool is_roundtrip;
+};
+
+// остановка 11 есть только у Bus 4: без него до неё не доехать
+const std::vector<BusDescription> BUSES = {
+	{ "Bus 1"s, { 0, 1, 2, 3 }, false },
+	{ "Bus 2"s, { 4, 5, 6, 7, 3, 4 }, true },
+	{ "Bus 3"s, { 0, 4, 8, 9, 10 }, false },
+	{ "Bus 4"s, { 11, 10, 6, 2 }, false },
+	{ "Bus 5"s, { 1, 5, 9, 1 }, true },
+};
+
+const std::vector<std::string> ROUTING_MODES = {
+	"all_pairs"s, "dijkstra"s, "contraction_hierarchy"s, "a_star"s, "lazy_all_pairs"s, "alt"s, "bidirectional_dijkstra"s, "raptor"s,
+};
+
+const std::vector<std::string> GRAPH_MODELS = { "complete"s, "linear"s };
+
+std::string StopName(size_t index) {
+	return "Stop "s + std::to_string(index);
+}
+
+json::Document MakeBase(const std::string& without_bus, const std::string& routing_mode, const std::string& graph_model) {
+	json::Array base_requests;
+	for (size_t from = 0; from < STOP_COUNT; ++from) {
+		json::Dict road_distances;
+		for (size_t to = 0; to < STOP_COUNT; ++to) {
+			if (to != from) {
+				const int distance = 1000 + 137 * std::abs(static_cast<int>(from) - static_cast<int>(to)) + 53 * static_cast<int>(from * to % 5);
+				road_distances[StopName(to)] = distance;
+			}
+		}
+		base_requests.push_back(json::Dict{
+			{ "type"s, "Stop"s },
+			{ "name"s, StopName(from) },
+			{ "latitude"s, 55.6 + 0.005 * (from % 4) },
+			{ "longitude"s, 37.6 + 0.007 * (from / 4) },
+			{ "road_distances"s, road_distances },
+		});
+	}
+	for (const BusDescription& bus : BUSES) {
+		if (bus.name == without_bus) {
+			continue;
+		}
+		json::Array stops;
+		for (const size_t stop : bus.stops) {
+			stops.push_back(StopName(stop));
+		}
+		base_requests.push_back(json::Dict{
+			{ "type"s, "Bus"s },
+			{ "name"s, bus.name },
+			{ "stops"s, stops },
+			{ "is_roundtrip"s, bus.is_roundtrip },
+		});
+	}
+	json::Dict routing_settings{
+		{ "bus_wait_time"s, 6 },
+		{ "bus_velocity"s, 40 },
+		{ "routing_mode"s, routing_mode },
+		{ "graph_model"s, graph_model },
+	};
+	return json::Document{ json::Dict{
+		{ "base_requests"s, base_requests },
+		{ "routing_settings"s, routing_settings },
+	} };
+}
+
+void Fill(transport_catalogue::TransportCatalogue& catalogue, transport_router::TransportRouter& router,
+	const std::string& without_bus, const std::string& routing_mode, const std::string& graph_model) {
+	JesonReader reader(MakeBase(without_bus, routing_mode, graph_model));
+	reader.FiilCatalogue(catalogue);
+	reader.FillRouteProperties(router, catalogue);
+}
+
+// число пар остановок, для которых время в пути различается
+size_t CountMismatches(const transport_router::TransportRouter& updated, const transport_router::TransportRouter& expected) {
+	std::vector<std::string> names;
+	for (size_t stop = 0; stop < STOP_COUNT; ++stop) {
+		names.push_back(StopName(stop));
+	}
+	const std::vector<std::string_view> names_to(names.begin(), names.end());
+
+	size_t mismatches = 0;
+	for (const std::string& from : names) {
+		const auto updated_times = updated.BuildRouteTimes(from, names_to);
+		const auto expected_times = expected.BuildRouteTimes(from, names_to);
+		for (size_t to = 0; to < names_to.size(); ++to) {
+			if (updated_times[to].has_value() != expected_times[to].has_value()
+				|| (updated_times[to] && std::abs(*updated_times[to] - *expected_times[to]) > 1e-9 * std::max(1.0, *expected_times[to]))) {
+				++mismatches;
+			}
+		}
+	}
+	return mismatches;
+}
+
+// false и сообщение в std::cerr, если проверка не прошла
+bool Check(bool condition, const std::string& routing_mode, const std::string& graph_model, const std::string& bus_name,
+	const std::string& message) {
+	if (!condition) {
+		std::cerr << routing_mode << ", "s << graph_model << ", "s << bus_name << ": "s << message << std::endl;
+	}
+	return condition;
+}
+
+}//namespace
+
+int main() {
+	size_t failures = 0;
+	for (const std::string& graph_model : GRAPH_MODELS) {
+		for (const std::string& routing_mode : ROUTING_MODES) {
+			transport_catalogue::TransportCatalogue full_catalogue;
+			transport_router::TransportRouter full_router;
+			Fill(full_catalogue, full_router, ""s, routing_mode, graph_model);
+
+			for (const BusDescription& bus : BUSES) {
+				transport_catalogue::TransportCatalogue reduced_catalogue;
+				transport_router::TransportRouter reduced_router;
+				Fill(reduced_catalogue, reduced_router, bus.name, routing_mode, graph_model);
+
+				transport_catalogue::TransportCatalogue catalogue;
+				transport_router::TransportRouter router;
+				Fill(catalogue, router, ""s, routing_mode, graph_model);
+
+				router.RemoveBus(bus.name);
+				failures += !Check(CountMismatches(router, reduced_router) == 0, routing_mode, graph_model, bus.name,
+					"RemoveBus differs from the base without the bus"s);
+
+				router.AddBus(catalogue, *catalogue.FindBus(bus.name));
+				failures += !Check(CountMismatches(router, full_router) == 0, routing_mode, graph_model, bus.name,
+					"AddBus differs from the full base"s);
+				failures += !Check(router.GetGraph().GetVertexCount() == full_router.GetGraph().GetVertexCount(),
+					routing_mode, graph_model, bus.name, "AddBus didn't reuse the freed vertices"s);
+
+				bool rejected = false;
+				try {
+					router.AddBus(catalogue, *catalogue.FindBus(bus.name));
+				}
+				catch (const std::invalid_argument&) {
+					rejected = true;
+				}
+				failures += !Check(rejected && CountMismatches(router, full_router) == 0, routing_mode, graph_model, bus.name,
+					"second AddBus of the same bus wasn't rejected"s);
+			}
+		}
+	}
+
+	if (failures > 0) {
+		std::cerr << failures << " check(s) failed"s << std::endl;
+		return EXIT_FAILURE;
+	}
+	std::cout << "OK"s << std::endl;
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,72 @@
+#include "test_base.h"
+
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Проверка transport_catalogue::UniqueStopCounter: число разных остановок должно совпасть с std::set
+// для маршрутов с повторами, когда один счётчик считает много маршрутов подряд, в том числе
+// при переполнении номера прохода
+
+using namespace tc_project;
+using namespace tc_project::test;
+using namespace std::literals;
+
+namespace {
+
+constexpr size_t STOP_COUNT = 50;
+constexpr size_t ROUTE_COUNT = 2000;
+
+// номер последнего прохода: с нуля и так, чтобы переполнение пришлось на середину
+const std::vector<uint32_t> START_EPOCHS = { 0, std::numeric_limits<uint32_t>::max() - ROUTE_COUNT / 2 };
+
+// маршруты длиной 0-40 с частыми повторами, иногда из одной остановки
+std::vector<std::vector<uint32_t>> MakeRoutes(uint32_t seed) {
+	std::mt19937 generator(seed);
+	std::vector<std::vector<uint32_t>> routes;
+	for (size_t i = 0; i < ROUTE_COUNT; ++i) {
+		const size_t length = generator() % 41;
+		const auto stop_range = static_cast<uint32_t>(1 + generator() % STOP_COUNT);
+		std::vector<uint32_t> route;
+		for (size_t j = 0; j < length; ++j) {
+			route.push_back(static_cast<uint32_t>(generator() % stop_range));
+		}
+		routes.push_back(std::move(route));
+	}
+	return routes;
+}
+
+}//namespace
+
+int main() {
+	const std::vector<std::vector<uint32_t>> routes = MakeRoutes(23);
+
+	size_t failures = 0;
+	for (const uint32_t start_epoch : START_EPOCHS) {
+		transport_catalogue::UniqueStopCounter counter(STOP_COUNT, start_epoch);
+		size_t mismatches = 0;
+		for (const std::vector<uint32_t>& route : routes) {
+			const std::set<uint32_t> expected(route.begin(), route.end());
+			mismatches += counter.Count(route.data(), route.data() + route.size()) != expected.size();
+		}
+		failures += !Check(mismatches == 0, "epoch "s + std::to_string(start_epoch) + ": "s + std::to_string(mismatches) + " route(s) counted wrong"s);
+	}
+
+	// номер остановки вне каталога - ошибка, а не запись за границу
+	transport_catalogue::UniqueStopCounter counter(STOP_COUNT);
+	const std::vector<uint32_t> bad_route = { 0, static_cast<uint32_t>(STOP_COUNT) };
+	bool rejected = false;
+	try {
+		counter.Count(bad_route.data(), bad_route.data() + bad_route.size());
+	}
+	catch (const std::out_of_range&) {
+		rejected = true;
+	}
+	failures += !Check(rejected, "stop id out of the catalogue wasn't rejected"s);
+
+	return Finish(failures);
+}